@@ -0,0 +1,259 @@
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include <util/crc16.h>
+#include "GameStorage.h"
+#include "eepromLayout.h"
+
+#ifdef _ENABLE_GAME_STORAGE_
+
+// sequence number + game state + CRC
+const uint16_t SLOT_SIZE = 1 + GAME_STATE_SIZE + 2;
+// save steps after the game state and the CRC: the slot is read back by
+// 'update()', then the interrupt writes the sequence number
+const uint16_t SAVE_VERIFY = GAME_STATE_SIZE + 2;
+const uint16_t SAVE_COMMIT = GAME_STATE_SIZE + 3;
+// save state machine is idle
+const uint16_t SAVE_IDLE = 0xffff;
+
+#if defined(EE_RDY_vect)
+  #define STORAGE_EEPROM_READY_vect EE_RDY_vect
+#elif defined(EE_READY_vect)
+  #define STORAGE_EEPROM_READY_vect EE_READY_vect
+#endif
+
+GameStorage gameStorage;
+
+// the game to be saved
+static Game *storedGame = nullptr;
+// slot and sequence number of the latest complete save
+static uint8_t currentSlot = EEPROM_STORAGE_SLOTS - 1;
+static uint8_t currentSequence = 0;
+// save in progress: next step (or SAVE_IDLE)
+static volatile uint16_t saveStep = SAVE_IDLE;
+// another save was requested while saving
+static bool savePending = false;
+static uint8_t saveSlot;
+static uint8_t saveSequence;
+// CRC of the state at the time of the request
+static uint16_t saveCrc;
+
+/*--------------------------------------------------------------*/
+static uint8_t *slotAddress( const uint8_t slot, const uint16_t offset )
+{
+  return( (uint8_t *)uintptr_t( EEPROM_STORAGE_START + slot * SLOT_SIZE + offset ) );
+}
+
+/*--------------------------------------------------------------*/
+// CRC of the sequence number and the game state stored in a slot
+static uint16_t slotCrc( const uint8_t slot, const uint8_t sequence )
+{
+  uint16_t crc = _crc_ccitt_update( 0xffff, sequence );
+  for ( uint16_t n = 1; n < 1 + GAME_STATE_SIZE; n++ )
+  {
+    crc = _crc_ccitt_update( crc, eeprom_read_byte( slotAddress( slot, n ) ) );
+  }
+  return( crc );
+}
+
+/*--------------------------------------------------------------*/
+// Checks the CRC of a slot
+static bool isSlotValid( const uint8_t slot )
+{
+  uint16_t crc = slotCrc( slot, eeprom_read_byte( slotAddress( slot, 0 ) ) );
+  return(    ( eeprom_read_byte( slotAddress( slot, 1 + GAME_STATE_SIZE ) ) == uint8_t( crc ) )
+          && ( eeprom_read_byte( slotAddress( slot, 2 + GAME_STATE_SIZE ) ) == uint8_t( crc >> 8 ) ) );
+}
+
+/*--------------------------------------------------------------*/
+// Takes the CRC of the current state (called from the main loop while the
+// interrupt is stopped). The state bytes are read again while they are written,
+// if the game changes in the meantime the slot doesn't match this CRC and isn't
+// committed (see 'GameStorage::update()').
+static void startSave()
+{
+  saveSlot = ( currentSlot + 1 ) % EEPROM_STORAGE_SLOTS;
+  saveSequence = currentSequence + 1;
+  saveCrc = _crc_ccitt_update( 0xffff, saveSequence );
+  for ( uint16_t n = 0; n < GAME_STATE_SIZE; n++ )
+  {
+    saveCrc = _crc_ccitt_update( saveCrc, storedGame->getStateByte( n ) );
+  }
+  saveStep = 0;
+}
+
+/*--------------------------------------------------------------*/
+// Advances the save until an EEPROM write was started (or the save has to be
+// verified or is complete). Order: game state, CRC and - after 'update()' has
+// verified the slot - the sequence number.
+static void saveSteps()
+{
+  while ( ( saveStep != SAVE_IDLE ) && ( saveStep != SAVE_VERIFY ) )
+  {
+    uint16_t step = saveStep++;
+    uint16_t offset;
+    uint8_t value;
+
+    if ( step < GAME_STATE_SIZE )
+    {
+      offset = 1 + step;
+      value = storedGame->getStateByte( step );
+    }
+    else if ( step < SAVE_VERIFY )
+    {
+      offset = 1 + step;
+      value = ( step == GAME_STATE_SIZE ) ? uint8_t( saveCrc ) : uint8_t( saveCrc >> 8 );
+    }
+    else
+    {
+      // commit
+      offset = 0;
+      value = saveSequence;
+      currentSlot = saveSlot;
+      currentSequence = saveSequence;
+      saveStep = SAVE_IDLE;
+    }
+
+    // only write what has changed
+    uint8_t *address = slotAddress( saveSlot, offset );
+    if ( eeprom_read_byte( address ) != value )
+    {
+      eeprom_write_byte( address, value );
+      return;
+    }
+  }
+}
+
+/*--------------------------------------------------------------*/
+// Lets the interrupt write the save (or writes it synchronously on the host).
+static void continueSave()
+{
+#ifdef STORAGE_EEPROM_READY_vect
+  // the interrupt fires as soon as the EEPROM is ready
+  EECR |= ( 1 << EERIE );
+#else
+  // no EEPROM interrupt (host)
+  while ( ( saveStep != SAVE_IDLE ) && ( saveStep != SAVE_VERIFY ) ) { saveSteps(); }
+#endif
+}
+
+#ifdef STORAGE_EEPROM_READY_vect
+/*--------------------------------------------------------------*/
+// the EEPROM is ready for the next byte
+ISR( STORAGE_EEPROM_READY_vect )
+{
+  saveSteps();
+  // nothing more to do until 'update()' has verified the slot?
+  if ( ( saveStep == SAVE_IDLE ) || ( saveStep == SAVE_VERIFY ) ) { EECR &= ~( 1 << EERIE ); }
+}
+#endif
+
+/*--------------------------------------------------------------*/
+// Finds the latest valid slot.
+void GameStorage::begin( Game &game )
+{
+  storedGame = &game;
+
+  bool found = false;
+  for ( uint8_t slot = 0; slot < EEPROM_STORAGE_SLOTS; slot++ )
+  {
+    if ( isSlotValid( slot ) )
+    {
+      uint8_t sequence = eeprom_read_byte( slotAddress( slot, 0 ) );
+      // sequence numbers wrap around, so compare the distance
+      if ( !found || ( int8_t( sequence - currentSequence ) > 0 ) )
+      {
+        currentSlot = slot;
+        currentSequence = sequence;
+        found = true;
+      }
+    }
+  }
+}
+
+/*--------------------------------------------------------------*/
+// Restores the latest saved game - only if it is still running.
+bool GameStorage::restore()
+{
+  if ( !isSlotValid( currentSlot ) ) { return( false ); }
+  if ( Status( eeprom_read_byte( slotAddress( currentSlot, 1 ) ) ) != Status::playGame ) { return( false ); }
+
+  for ( uint16_t n = 0; n < GAME_STATE_SIZE; n++ )
+  {
+    storedGame->setStateByte( n, eeprom_read_byte( slotAddress( currentSlot, 1 + n ) ) );
+  }
+  // the cursor isn't part of the level data
+  storedGame->setCursorPosition( storedGame->getCursorX(), storedGame->getCursorY() );
+  return( true );
+}
+
+/*--------------------------------------------------------------*/
+// Saves the game in the background.
+void GameStorage::requestSave()
+{
+  bool busy;
+  ATOMIC_BLOCK( ATOMIC_RESTORESTATE ) { busy = ( saveStep != SAVE_IDLE ); }
+
+  if ( busy )
+  {
+    // save again, when the current save is done
+    savePending = true;
+  }
+  else
+  {
+    startSave();
+    continueSave();
+  }
+#ifndef STORAGE_EEPROM_READY_vect
+  // the host saves synchronously
+  while ( isBusy() ) {}
+#endif
+}
+
+/*--------------------------------------------------------------*/
+// Verifies and commits the slot written by the interrupt, or starts the next
+// save. Call it from the main loop (every frame while playing).
+void GameStorage::update()
+{
+  uint16_t step;
+  ATOMIC_BLOCK( ATOMIC_RESTORESTATE ) { step = saveStep; }
+
+  // the interrupt is stopped in both cases
+  if ( step == SAVE_VERIFY )
+  {
+    if ( slotCrc( saveSlot, saveSequence ) == saveCrc )
+    {
+      saveStep = SAVE_COMMIT;
+    }
+    else
+    {
+      // torn state: save the current state to the same slot
+      savePending = false;
+      startSave();
+    }
+  }
+  else if ( ( step == SAVE_IDLE ) && savePending )
+  {
+    // the game changed while saving
+    savePending = false;
+    startSave();
+  }
+  else
+  {
+    return;
+  }
+  continueSave();
+}
+
+/*--------------------------------------------------------------*/
+bool GameStorage::isBusy()
+{
+  update();
+
+  bool busy;
+  ATOMIC_BLOCK( ATOMIC_RESTORESTATE ) { busy = ( saveStep != SAVE_IDLE ); }
+  return( busy );
+}
+
+#endif
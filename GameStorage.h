@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Arduino.h>
+#include "TinyMinezGame.h"
+
+// Save the running game to EEPROM and continue after power loss.
+// Without this define the storage isn't compiled (and the EEPROM interrupt is free).
+//#define _ENABLE_GAME_STORAGE_
+
+#ifdef _ENABLE_GAME_STORAGE_
+///////////////////////////////////////////////
+// Keeps the running game in EEPROM, so it survives a power loss.
+//
+// The state is written to a ring of slots (wear levelling), every slot contains
+//   [0]     sequence number (the highest valid one wins)
+//   [1..n]  game state (see Game::getStateByte())
+//   [n+1..] CRC-CCITT over sequence number and game state
+// The sequence number is written last, so an interrupted save never
+// destroys the previous one. Only bytes which differ from the slot's old
+// content are written (that is the save before the last two, so usually
+// more than the changes since the last save).
+//
+// On AVR the bytes are written from the EEPROM ready interrupt, so saving
+// doesn't block the game loop (~3.4ms per changed byte in the background).
+// The CRC is taken when the save is requested. The interrupt stops after the
+// CRC, 'update()' (main loop) reads the slot back: a slot which was written
+// while the game changed doesn't match and is written again instead of committed.
+// The cursor is only stored as cursorX/cursorY, moving it doesn't change the state.
+class GameStorage
+{
+public:
+  void      begin( Game &game );
+  bool      restore();
+  void      requestSave();
+  void      update();
+  bool      isBusy();
+};
+
+extern GameStorage gameStorage;
+#endif
@@ -0,0 +1,203 @@
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include <util/atomic.h>
+#include "Replay.h"
+#include "GameStorage.h"
+#include "eepromLayout.h"
+
+// size of magic, number of mines and seed
+const uint8_t REPLAY_HEADER_SIZE = 6;
+
+/*--------------------------------------------------------------*/
+// true if the cursor delta fits into a single event
+static bool isDeltaInRange( const int8_t deltaX, const int8_t deltaY )
+{
+  return( ( deltaX >= -4 ) && ( deltaX <= 3 ) && ( deltaY >= -4 ) && ( deltaY <= 3 ) );
+}
+
+/*--------------------------------------------------------------*/
+Replay::Replay() : _writePosition( 0 ), _lastX( 0 ), _lastY( 0 ), _pendingX( 0 ), _pendingY( 0 )
+{
+}
+
+/*--------------------------------------------------------------*/
+// Starts a new recording - call this right after 'Game::createLevel()'.
+void Replay::startRecording( Game &game )
+{
+  long seed = game.getSeed();
+
+  // invalidate the old recording first, so a power loss can't leave a mixed log
+  writeByte( 0, REPLAY_END );
+  writeByte( 1, game.getMinesCount() );
+  for ( uint8_t n = 0; n < 4; n++ )
+  {
+    writeByte( 2 + n, uint8_t( seed >> ( n * 8 ) ) );
+  }
+  writeByte( REPLAY_HEADER_SIZE, REPLAY_END );
+  writeByte( 0, REPLAY_MAGIC );
+
+  _writePosition = REPLAY_HEADER_SIZE;
+  _lastX = _pendingX = game.getCursorX();
+  _lastY = _pendingY = game.getCursorY();
+}
+
+/*--------------------------------------------------------------*/
+// Records the cursor movement since the last event and the action at the new position.
+// Plain moves are only kept in RAM until the delta doesn't fit into one event anymore
+// or the next action is recorded (which carries the delta), so holding a direction
+// doesn't rewrite the EEPROM every frame.
+void Replay::recordEvent( const uint8_t action, const uint8_t cursorX, const uint8_t cursorY )
+{
+  if ( action == REPLAY_MOVE )
+  {
+    // the pending move can't be extended, log it
+    if (    !isDeltaInRange( cursorX - _lastX, cursorY - _lastY )
+         && ( ( _pendingX != _lastX ) || ( _pendingY != _lastY ) ) )
+    {
+      logEvent( REPLAY_MOVE, _pendingX, _pendingY );
+    }
+  }
+  else
+  {
+    logEvent( action, cursorX, cursorY );
+  }
+
+  _pendingX = cursorX;
+  _pendingY = cursorY;
+}
+
+/*--------------------------------------------------------------*/
+// Appends the action at x,y to the log, large jumps are split into several moves.
+void Replay::logEvent( const uint8_t action, const uint8_t x, const uint8_t y )
+{
+  int8_t deltaX = x - _lastX;
+  int8_t deltaY = y - _lastY;
+
+  while ( !isDeltaInRange( deltaX, deltaY ) )
+  {
+    int8_t stepX = constrain( deltaX, -4, 3 );
+    int8_t stepY = constrain( deltaY, -4, 3 );
+    appendEvent( REPLAY_MOVE | ( ( stepX + 4 ) << 3 ) | ( stepY + 4 ) );
+    deltaX -= stepX;
+    deltaY -= stepY;
+  }
+
+  appendEvent( action | ( ( deltaX + 4 ) << 3 ) | ( deltaY + 4 ) );
+
+  _lastX = x;
+  _lastY = y;
+}
+
+/*--------------------------------------------------------------*/
+bool Replay::hasRecording()
+{
+  return( readByte( 0 ) == REPLAY_MAGIC );
+}
+
+/*--------------------------------------------------------------*/
+long Replay::getRecordedSeed()
+{
+  long seed = 0;
+  for ( uint8_t n = 0; n < 4; n++ )
+  {
+    seed |= long( readByte( 2 + n ) ) << ( n * 8 );
+  }
+  return( seed );
+}
+
+/*--------------------------------------------------------------*/
+// Replays the recorded game at full speed and returns the final status.
+Status Replay::play( Game &game )
+{
+  if ( !hasRecording() ) { return( game.getStatus() ); }
+
+  // recreate the level
+  game.setSeed( getRecordedSeed() );
+  game.createLevel( readByte( 1 ) );
+  game.setStatus( Status::playGame );
+
+  uint8_t cursorX = game.getCursorX();
+  uint8_t cursorY = game.getCursorY();
+
+  for ( uint16_t offset = REPLAY_HEADER_SIZE; offset < EEPROM_REPLAY_SIZE; offset++ )
+  {
+    uint8_t event = readByte( offset );
+    if ( event == REPLAY_END ) { break; }
+
+    cursorX += ( ( event >> 3 ) & 0x07 ) - 4;
+    cursorY += ( event & 0x07 ) - 4;
+    game.setCursorPosition( cursorX, cursorY );
+
+    switch ( event & 0xc0 )
+    {
+      case REPLAY_UNCOVER:
+        // uncovering a flagged tile is ignored
+        if ( !game.hasFlag( cursorX, cursorY ) ) { game.uncoverAndUpdateStatus( cursorX, cursorY ); }
+        break;
+      case REPLAY_FLAG:
+        game.toggleFlag( cursorX, cursorY );
+        break;
+    }
+
+    if ( ( game.getStatus() == Status::boom ) || ( game.getStatus() == Status::gameWon ) ) { break; }
+  }
+
+  return( game.getStatus() );
+}
+
+/*--------------------------------------------------------------*/
+bool Replay::appendEvent( const uint8_t event )
+{
+  // not recording or log full? (the last byte is reserved for the end marker)
+  if ( ( _writePosition == 0 ) || ( _writePosition >= EEPROM_REPLAY_SIZE - 1 ) ) { return( false ); }
+
+  // terminate first, so the log stays valid at any time
+  writeByte( _writePosition + 1, REPLAY_END );
+  writeByte( _writePosition, event );
+  _writePosition++;
+
+  return( true );
+}
+
+/*--------------------------------------------------------------*/
+// The EEPROM is shared with GameStorage, which writes from an interrupt.
+// Waits (with interrupts enabled) until its save is done and the EEPROM is
+// ready, the caller accesses the registers atomically only if it still is.
+static void waitForEeprom()
+{
+#ifdef _ENABLE_GAME_STORAGE_
+  while ( gameStorage.isBusy() ) {}
+#endif
+  while ( !eeprom_is_ready() ) {}
+}
+
+/*--------------------------------------------------------------*/
+uint8_t Replay::readByte( const uint16_t offset )
+{
+  for (;;)
+  {
+    waitForEeprom();
+    ATOMIC_BLOCK( ATOMIC_RESTORESTATE )
+    {
+      if ( eeprom_is_ready() ) { return( eeprom_read_byte( (const uint8_t *)uintptr_t( EEPROM_REPLAY_START + offset ) ) ); }
+    }
+  }
+}
+
+/*--------------------------------------------------------------*/
+// Only starts the write, the EEPROM programs the byte with interrupts enabled.
+void Replay::writeByte( const uint16_t offset, const uint8_t value )
+{
+  for (;;)
+  {
+    waitForEeprom();
+    ATOMIC_BLOCK( ATOMIC_RESTORESTATE )
+    {
+      if ( eeprom_is_ready() )
+      {
+        eeprom_update_byte( (uint8_t *)uintptr_t( EEPROM_REPLAY_START + offset ), value );
+        return;
+      }
+    }
+  }
+}
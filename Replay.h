@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Arduino.h>
+#include "TinyMinezGame.h"
+
+///////////////////////////////////////////////
+// Records the player's input of the current game to EEPROM, so a session
+// can be reproduced later (e.g. on the host for profiling or debugging).
+//
+// Log layout:
+//   [0]    REPLAY_MAGIC
+//   [1]    number of mines
+//   [2..5] seed (little endian)
+//   [6..]  events, terminated by REPLAY_END
+//
+// Every event is a single byte: 'ttxxxyyy'
+//   tt  - action (REPLAY_MOVE, REPLAY_UNCOVER, REPLAY_FLAG)
+//   xxx - cursor delta x + 4 (-4..3)
+//   yyy - cursor delta y + 4 (-4..3)
+// The cursor is moved first, then the action is performed at the new position.
+// Moves are merged in RAM, a move without a following action may be missing
+// at the end of the log (it doesn't change the game).
+class Replay
+{
+public:
+  enum
+  {
+    REPLAY_MOVE    = 0x00,
+    REPLAY_UNCOVER = 0x40,
+    REPLAY_FLAG    = 0x80,
+    REPLAY_END     = 0xff,
+    REPLAY_MAGIC   = 0xa5,
+  };
+
+  Replay();
+  void      startRecording( Game &game );
+  void      recordEvent( const uint8_t action, const uint8_t cursorX, const uint8_t cursorY );
+  bool      hasRecording();
+  long      getRecordedSeed();
+  Status    play( Game &game );
+
+private:
+  void      logEvent( const uint8_t action, const uint8_t x, const uint8_t y );
+  bool      appendEvent( const uint8_t event );
+  uint8_t   readByte( const uint16_t offset );
+  void      writeByte( const uint16_t offset, const uint8_t value );
+
+private:
+  // position of the next event in the log (0 = not recording)
+  uint16_t  _writePosition;
+  // cursor position of the last event
+  uint8_t   _lastX;
+  uint8_t   _lastY;
+  // cursor position of the moves which are not logged yet
+  uint8_t   _pendingX;
+  uint8_t   _pendingY;
+};
@@ -3,6 +3,10 @@
 #include <Arduino.h>
 #include <EEPROM.h>
 #include "SerialHexTools.h"
+#include "RLEdecompression.h"
+
+static uint8_t hexdumpPositionCount = 0;
+const uint8_t hexdumpValuesPerLine = 16;
 
 /*--------------------------------------------------------------*/
 void hexdumpResetPositionCount() 
@@ -109,4 +113,132 @@ void printScreenBufferToSerial( const uint8_t *buffer, const uint8_t widthInPixe
   }
 }
 
+/*--------------------------------------------------------------*/
+// CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xffff)
+uint16_t crc16Update( uint16_t crc, uint8_t value )
+{
+  crc ^= uint16_t( value ) << 8;
+  for ( uint8_t n = 0; n < 8; n++ )
+  {
+    crc = ( crc & 0x8000 ) ? ( crc << 1 ) ^ 0x1021 : ( crc << 1 );
+  }
+  return( crc );
+}
+
+/*--------------------------------------------------------------*/
+// checksum of the frame currently being sent
+static uint16_t frameCrc;
+
+/*--------------------------------------------------------------*/
+static void frameWrite( uint8_t value )
+{
+  frameCrc = crc16Update( frameCrc, value );
+  Serial.write( value );
+}
+
+/*--------------------------------------------------------------*/
+// Length of the run starting at 'data' (limited to 'maxCount')
+static uint8_t runLength( const uint8_t *data, uint16_t byteCount, uint8_t maxCount )
+{
+  uint8_t count = 1;
+  while ( ( count < maxCount ) && ( count < byteCount ) && ( data[count] == data[0] ) )
+  {
+    count++;
+  }
+  return( count );
+}
+
+/*--------------------------------------------------------------*/
+// Is it cheaper to encode a run at 'data' than to copy the bytes?
+static bool isRunWorthy( const uint8_t *data, uint16_t byteCount )
+{
+  // 0x00 and 0xff runs cost one byte, all other runs two bytes
+  uint8_t minimumRun = ( ( data[0] == 0x00 ) || ( data[0] == 0xff ) ) ? 2 : 3;
+  return( runLength( data, byteCount, minimumRun ) >= minimumRun );
+}
+
+/*--------------------------------------------------------------*/
+// Encodes the data with the same RLE scheme 'pgm_RLEdecompress()' understands.
+// Returns the encoded size and only writes the data if 'send' is true,
+// this way the frame length can be determined before sending anything.
+static uint16_t RLEcompressToSerial( const uint8_t *data, uint16_t byteCount, bool send )
+{
+  uint16_t encodedSize = 0;
+
+  while ( byteCount != 0 )
+  {
+    if ( isRunWorthy( data, byteCount ) )
+    {
+      uint8_t count = runLength( data, byteCount, 32 );
+      uint8_t value = data[0];
+      uint8_t code = RLE_COMPRESSED_DATA | ( count - 1 );
+
+      if ( value == 0xff ) { code |= RLE_COMPRESSED_0xFF; }
+      else if ( value == 0x00 ) { code |= RLE_COMPRESSED_0x00; }
+
+      if ( send ) { frameWrite( code ); }
+      encodedSize++;
+      if ( !( code & ( RLE_COMPRESSED_0xFF | RLE_COMPRESSED_0x00 ) ) )
+      {
+        if ( send ) { frameWrite( value ); }
+        encodedSize++;
+      }
+
+      data += count;
+      byteCount -= count;
+    }
+    else
+    {
+      // collect literal bytes until the next run starts
+      uint8_t count = 1;
+      while ( ( count < 128 ) && ( count < byteCount ) && !isRunWorthy( data + count, byteCount - count ) )
+      {
+        count++;
+      }
+
+      if ( send )
+      {
+        frameWrite( count - 1 );
+        for ( uint8_t n = 0; n < count; n++ ) { frameWrite( data[n] ); }
+      }
+      encodedSize += 1 + count;
+
+      data += count;
+      byteCount -= count;
+    }
+  }
+
+  return( encodedSize );
+}
+
+/*--------------------------------------------------------------*/
+// Sends a binary frame: the (small) header is sent as is, the data is RLE compressed.
+void serialSendFrame( const uint8_t type, const uint8_t *header, const uint8_t headerLength, const uint8_t *data, const uint16_t dataLength )
+{
+  uint16_t length = headerLength + RLEcompressToSerial( data, dataLength, false );
+
+  Serial.write( SERIAL_FRAME_SYNC1 );
+  Serial.write( SERIAL_FRAME_SYNC2 );
+
+  frameCrc = 0xffff;
+  frameWrite( type );
+  frameWrite( length & 0xff );
+  frameWrite( length >> 8 );
+  for ( uint8_t n = 0; n < headerLength; n++ ) { frameWrite( header[n] ); }
+  RLEcompressToSerial( data, dataLength, true );
+
+  // the CRC itself must not be fed into the CRC
+  uint16_t crc = frameCrc;
+  Serial.write( crc & 0xff );
+  Serial.write( crc >> 8 );
+}
+
+/*--------------------------------------------------------------*/
+// send the screen buffer (SSD1306 page layout) as a binary frame
+void serialSendScreenBuffer( const uint8_t *buffer, const uint8_t widthInPixels, const uint8_t heightInBytes )
+{
+  uint8_t header[] = { widthInPixels, heightInBytes };
+  serialSendFrame( SERIAL_FRAME_SCREENSHOT, header, sizeof( header ), buffer, widthInPixels * heightInBytes );
+}
+
 #endif
@@ -5,13 +5,30 @@
 #if !(defined(__AVR_ATtiny85__)||defined(ARDUINO_AVR_ATTINYX4))
 #define HAVE_SERIAL_HEX
 
-  static uint8_t hexdumpPositionCount = 0;
-  static uint8_t hexdumpValuesPerLine = 16;
-
   void hexdumpResetPositionCount();
   void hexdumpToSerial( uint8_t *pData, uint16_t byteCount, bool finalComma = false, bool finalLinebreak = true );
   void EEPROM_hexdumpToSerial( uint16_t startAddress, uint16_t byteCount, bool finalComma = false, bool finalLinebreak = true );
   void pgm_hexdumpToSerial( uint8_t *pData, uint16_t byteCount, bool finalComma = false, bool finalLinebreak = true );
   void printHexToSerial( uint8_t value, bool addComma = false );
   void printScreenBufferToSerial( const uint8_t *buffer, const uint8_t widthInPixels, const uint8_t heightInBytes );
+
+// Send screenshots, level dumps and status as compact binary frames instead of text
+// (use 'tools/serial_receiver.py' for decoding). Comment out to get the old text output.
+#define SERIAL_BINARY_FRAMES
+
+  // Frame layout: SYNC1 SYNC2 type lengthLo lengthHi payload[length] crcLo crcHi
+  // The CRC (CRC-16/CCITT-FALSE) covers type, length and payload.
+  const uint8_t SERIAL_FRAME_SYNC1 = 0xA5;
+  const uint8_t SERIAL_FRAME_SYNC2 = 0x5A;
+
+  enum SerialFrameType : uint8_t
+  {
+    SERIAL_FRAME_SCREENSHOT  = 'S',   // width, heightInBytes, RLE compressed screen buffer
+    SERIAL_FRAME_LEVEL       = 'L',   // status, width, height, mines, flags, hidden, clicks (16 bit), seed (32 bit), RLE compressed level
+    SERIAL_FRAME_GAME_STATUS = 'G',   // status
+  };
+
+  uint16_t crc16Update( uint16_t crc, uint8_t value );
+  void serialSendFrame( const uint8_t type, const uint8_t *header, const uint8_t headerLength, const uint8_t *data, const uint16_t dataLength );
+  void serialSendScreenBuffer( const uint8_t *buffer, const uint8_t widthInPixels, const uint8_t heightInBytes );
 #endif
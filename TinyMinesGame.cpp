@@ -2,34 +2,54 @@
 #include "TinyMinezGame.h"
 #include "tinyJoypadUtils.h"
 #include "soundFX.h"
+#include "tinyRandom.h"
+#include "profiler.h"
+#ifdef GAME_BITBOARDS
+  #include "bitBoard.h"
+#endif
 
 #if !(defined(__AVR_ATtiny85__)||defined(ARDUINO_AVR_ATTINYX4))
   #include "SerialHexTools.h"
 #endif
 
 /*--------------------------------------------------------*/
-Game::Game() : Game( MAX_GAME_COLS, MAX_GAME_ROWS )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+BasicGame<WIDTH, HEIGHT>::BasicGame()
 {
-  // Intro screen
-  status = Status::intro;
+  initialize();
 }
 
 /*--------------------------------------------------------*/
-Game::Game( uint8_t levelWidth, uint8_t levelHeight ) : minesCount( 0 ), flagsCount( 0 ), clicksCount( 0 ),
-                                                        levelWidth( levelWidth ), levelHeight( levelHeight ),
-                                                        cursorX( levelWidth / 2 ), cursorY( levelHeight / 2 ),
-                                                        seed( 0 )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::initialize()
 {
+  minesCount = 0;
+  flagsCount = 0;
+  clicksCount = 0;
+  cursorX = levelWidth / 2;
+  cursorY = levelHeight / 2;
+  seed = 0;
+#ifdef PROGRESSIVE_REVEAL
+  uncovering = false;
+#endif
   // Intro screen
   status = Status::intro;
   // clear level - just in case
   clearLevel();
+#ifdef MEMORY_MONITOR_ENABLED
+  // arm the sentinels
+  levelGuardFront = LEVEL_GUARD;
+  levelGuardBack = LEVEL_GUARD;
+#endif
 }
 
 /*--------------------------------------------------------*/
 // Creates a level with 'numOfMines' randomly placed mines.
-void Game::createLevel( uint8_t numOfMines )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::createLevel( uint8_t numOfMines )
 {
+  PROFILE_BEGIN( PROFILE_CREATE_LEVEL );
+
   // clear the level
   clearLevel();
 
@@ -39,9 +59,13 @@ void Game::createLevel( uint8_t numOfMines )
   flagsCount = 0;
   // no clicks
   clicksCount = 0;
+#ifdef PROGRESSIVE_REVEAL
+  // no flood fill in progress
+  uncovering = false;
+#endif
 
-  // set random seed to the live value
-  randomSeed( seed );
+  // the seed defines the level
+  tinyRandomSeed( seed );
 
   // now place the mines
   while ( numOfMines-- )
@@ -52,7 +76,7 @@ void Game::createLevel( uint8_t numOfMines )
     do
     {
       // get random position
-      pos = random( levelWidth * levelHeight );
+      pos = tinyRandomBelow( levelWidth * levelHeight );
 
     } while ( levelData[pos] != EMPTY );
 
@@ -60,6 +84,34 @@ void Game::createLevel( uint8_t numOfMines )
     levelData[pos] = BOMB;
   }
 
+#ifdef GAME_BITBOARDS
+  BitRow mines[MAX_GAME_ROWS];
+  bitBoardFromLevel( mines, levelData, levelWidth, levelHeight, BOMB, BOMB );
+
+  // count the bombs around all cells of a row at once and hide all cells
+  uint8_t *cell = levelData;
+  for ( uint8_t y = 0; y < levelHeight; y++ )
+  {
+    BitRow countBits[4];
+    bitBoardCountNeighbors( countBits, mines, y, levelWidth, levelHeight );
+
+    // mines don't get a count
+    BitRow noMine = ~mines[y];
+    BitRow bit0 = countBits[0] & noMine;
+    BitRow bit1 = countBits[1] & noMine;
+    BitRow bit2 = countBits[2] & noMine;
+    BitRow bit3 = countBits[3] & noMine;
+
+    for ( uint8_t x = 0; x < levelWidth; x++ )
+    {
+      *cell++ |= HIDDEN | ( bit0 & 1 ) | ( ( bit1 & 1 ) << 1 ) | ( ( bit2 & 1 ) << 2 ) | ( ( bit3 & 1 ) << 3 );
+      bit0 >>= 1;
+      bit1 >>= 1;
+      bit2 >>= 1;
+      bit3 >>= 1;
+    }
+  }
+#else
   // now count all bombs in the neightborhood
   for ( int8_t y = 0; y < levelHeight; y++ )
   {
@@ -85,17 +137,43 @@ void Game::createLevel( uint8_t numOfMines )
   {
     levelData[n] |= HIDDEN;
   }
+#endif
 
   // place cursor in the middle of the level
   cursorX = levelWidth / 2;
   cursorY = levelHeight / 2;
+
+  PROFILE_END( PROFILE_CREATE_LEVEL );
+
+#ifdef GAME_SELF_CHECK
+  checkInvariants();
+#endif
 }
 
 #if 1
 /*--------------------------------------------------------*/
 // uncovers all tiles adjacent to x,y
 // iterative version: not very elegant, but requires much less stack memory
-bool Game::uncoverCells( const int8_t x, const int8_t y )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+bool BasicGame<WIDTH, HEIGHT>::uncoverCells( const int8_t x, const int8_t y )
+{
+  uint8_t result = uncoverFirstCell( x, y );
+
+#ifdef GAME_BITBOARDS
+  if ( result == HIDDEN ) { uncoverRegion(); }
+#else
+  // because recursion requires too much stack space, we have to solve the problem iteratively
+  if ( result == HIDDEN ) { while ( uncoverStep( 0xff ) ); }
+#endif
+
+  return( result == BOMB );
+}
+
+/*--------------------------------------------------------*/
+// Uncovers the player's cell and prepares the flood fill. Returns BOMB for a mine,
+// HIDDEN if the flood fill has to follow and EMPTY if there was nothing to do.
+template <uint8_t WIDTH, uint8_t HEIGHT>
+uint8_t BasicGame<WIDTH, HEIGHT>::uncoverFirstCell( const int8_t x, const int8_t y )
 {
   uint8_t value = getCellValue( x, y );
 
@@ -103,7 +181,7 @@ bool Game::uncoverCells( const int8_t x, const int8_t y )
   if ( !( value & HIDDEN ) )
   {
     // no work here...
-    return( false );
+    return( EMPTY );
   }
 
   // count the click
@@ -115,63 +193,148 @@ bool Game::uncoverCells( const int8_t x, const int8_t y )
   if ( value & BOMB )
   {
     // GAME OVER...
-    return( true );
+    return( BOMB );
   }
 
-  bool cellUncovered;
+  // the flood fill starts with a new pass
+  fillX = 0;
+  fillY = 0;
+  return( HIDDEN );
+}
 
-  // because recursion requires too much stack space, we have to solve the problem iteratively
-  do
+/*--------------------------------------------------------*/
+// One slice of the flood fill: the board is scanned from the position where the
+// last slice stopped, the slice ends after 'budget' cells were uncovered.
+// Returns false if the fill is complete (a full pass didn't uncover anything).
+template <uint8_t WIDTH, uint8_t HEIGHT>
+bool BasicGame<WIDTH, HEIGHT>::uncoverStep( uint8_t budget )
+{
+  while ( true )
   {
-    blip4();
+    // a new pass?
+    if ( ( fillX == 0 ) && ( fillY == 0 ) )
+    {
+      blip4();
+      // no more cells uncovered yet
+      fillChanged = false;
+    }
+
+    // walk the (rest of the) board
+    while ( fillY < levelHeight )
+    {
+      uint8_t uncovered = uncoverAround( fillX, fillY );
+      if ( ++fillX >= levelWidth ) { fillX = 0; fillY++; }
+
+      if ( uncovered != 0 )
+      {
+        // a cell has been uncovered!
+        fillChanged = true;
+        if ( uncovered >= budget ) { return( true ); }
+        budget -= uncovered;
+      }
+    }
 
-    // no more cells uncovered yet
-    cellUncovered = false;
+    // the pass is complete
+    fillY = 0;
+    if ( !fillChanged ) { return( false ); }
+  }
+}
+
+/*--------------------------------------------------------*/
+// If x,y is an uncovered empty cell, all its hidden neighbors are uncovered.
+// Returns the number of uncovered cells.
+template <uint8_t WIDTH, uint8_t HEIGHT>
+uint8_t BasicGame<WIDTH, HEIGHT>::uncoverAround( const int8_t x, const int8_t y )
+{
+  uint8_t value = getCellValue( x, y ) & DATA_MASK;
+  // is this cell empty and already uncovered?
+  if ( value != EMPTY ) { return( 0 ); }
 
-    // walk the whole board
-    for ( int8_t posY = 0; posY < levelHeight; posY++ )
+  uint8_t uncovered = 0;
+
+  // check the neighborhood
+  for ( int8_t offsetY = -1; offsetY <=1; offsetY++ )
+  {
+    for ( int8_t offsetX = -1; offsetX <=1; offsetX++ )
     {
-      for ( int8_t posX = 0; posX < levelWidth; posX++ )
+      // check for borders
+      if ( isPositionValid( x + offsetX, y + offsetY ) )
       {
-        value = getCellValue( posX, posY ) & DATA_MASK;
-        // is this cell empty and already uncovered?
-        if ( !( value & HIDDEN ) && ( value == EMPTY ) )
+        // get the cell content (the cursor stays, the fill may run while it moves)
+        value = getCellValue( x + offsetX, y + offsetY );
+        // covered, but no bomb there?
+        if ( ( value & HIDDEN ) && !( value & BOMB ) )
         {
-          // check the neighborhood
-          for ( int8_t offsetY = -1; offsetY <=1; offsetY++ )
-          {
-            for ( int8_t offsetX = -1; offsetX <=1; offsetX++ )
-            {
-              // check for borders
-              if ( isPositionValid( posX + offsetX, posY + offsetY ) )
-              {
-                // get the cell content (and remove the cursor)
-                value =  getCellValue( posX + offsetX, posY + offsetY ) & DATA_MASK;
-                // covered, but no bomb there?
-                if ( ( value & HIDDEN ) && !( value & BOMB ) )
-                {
-                  // uncover this cell
-                  setCellValue( posX + offsetX, posY + offsetY, value & ~( HIDDEN | FLAG ) );
-                  // a cell has been uncovered!
-                  cellUncovered = true;
-                }
-              }
-            }
-          }
+          // uncover this cell
+          setCellValue( x + offsetX, y + offsetY, value & ~( HIDDEN | FLAG ) );
+          uncovered++;
         }
       }
     }
-  } while ( cellUncovered );
+  }
 
-  return( false );
+  return( uncovered );
 }
 
+#ifdef GAME_BITBOARDS
+/*--------------------------------------------------------*/
+// The complete flood fill with bitboards: the uncovered area grows by one cell
+// in all directions per round (a dilation), but only into hidden cells without
+// a mine and only from empty cells. Same result as 'uncoverStep()' until done.
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::uncoverRegion()
+{
+  // the border of the uncovered area, which can grow further (empty cells)
+  BitRow frontier[MAX_GAME_ROWS];
+  // hidden cells without a mine
+  BitRow safe[MAX_GAME_ROWS];
+  // cells without a mine and without mines around
+  BitRow empty[MAX_GAME_ROWS];
+
+  bitBoardFromLevel( frontier, levelData, levelWidth, levelHeight, DATA_MASK, EMPTY );
+  bitBoardFromLevel( safe, levelData, levelWidth, levelHeight, HIDDEN | BOMB, HIDDEN );
+  bitBoardFromLevel( empty, levelData, levelWidth, levelHeight, BOMB | COUNT_MASK, EMPTY );
+
+  blip4();
+
+  bool changed;
+  do
+  {
+    bitBoardDilate( frontier, levelWidth, levelHeight );
+
+    changed = false;
+    for ( uint8_t y = 0; y < levelHeight; y++ )
+    {
+      BitRow uncovered = frontier[y] & safe[y];
+      safe[y] &= ~uncovered;
+      // only the new empty cells can uncover more cells
+      frontier[y] = uncovered & empty[y];
+      if ( uncovered ) { changed = true; }
+    }
+  } while ( changed );
+
+  // uncover the cells which aren't 'safe' anymore (and remove their flags)
+  uint8_t *cell = levelData;
+  for ( uint8_t y = 0; y < levelHeight; y++ )
+  {
+    BitRow stillHidden = safe[y];
+    for ( uint8_t x = 0; x < levelWidth; x++ )
+    {
+      if ( ( ( *cell & ( HIDDEN | BOMB ) ) == HIDDEN ) && !( stillHidden & 1 ) ) { *cell &= ~( HIDDEN | FLAG ); }
+      stillHidden >>= 1;
+      cell++;
+    }
+  }
+}
+#endif
+
 #else
 
 /*--------------------------------------------------------*/
 // uncovers all tiles adjacent to x,y
 // recursive version - simple, but uses too much memory for the stack :(
-bool Game::uncoverCells( const int8_t x, const int8_t y, bool countClick /*= true*/ )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+bool BasicGame<WIDTH, HEIGHT>::uncoverCells( const int8_t x, const int8_t y, bool countClick /*= true*/ )
 {
   uint8_t value = getCellValue( x, y );
 
@@ -223,9 +386,137 @@ bool Game::uncoverCells( const int8_t x, const int8_t y, bool countClick /*= tru
 }
 #endif
 
+#ifdef GAME_SELF_CHECK
+/*--------------------------------------------------------*/
+// Cheap structural checks of the level:
+// - there are 'minesCount' mines and mines have no count
+// - flags are only on hidden cells
+// - 'isWon()' is true exactly when all safe cells are uncovered
+// On failure the reason and the level are sent to the serial port.
+// The neighbor counts and the flood fill are verified by an independent
+// model in the host tool 'host/selfCheck.cpp'.
+template <uint8_t WIDTH, uint8_t HEIGHT>
+bool BasicGame<WIDTH, HEIGHT>::checkInvariants()
+{
+  uint8_t mines = 0;
+  uint8_t hiddenSafeCells = 0;
+
+  for ( uint8_t position = 0; position < levelWidth * levelHeight; position++ )
+  {
+    uint8_t value = levelData[position] & DATA_MASK;
+
+    if ( value & BOMB )
+    {
+      mines++;
+      if ( value & COUNT_MASK ) { return( selfCheckFailed( F("mine with count"), position ) ); }
+    }
+    else if ( value & HIDDEN )
+    {
+      hiddenSafeCells++;
+    }
+
+    if ( ( value & FLAG ) && !( value & HIDDEN ) ) { return( selfCheckFailed( F("flag on uncovered cell"), position ) ); }
+  }
+
+  if ( mines != minesCount ) { return( selfCheckFailed( F("wrong number of mines"), 0 ) ); }
+  // after ***BOOM*** all mines are uncovered, so 'isWon()' is meaningless
+  if ( ( status != Status::boom ) && ( status != Status::gameOver ) && ( isWon() != ( hiddenSafeCells == 0 ) ) )
+  {
+    return( selfCheckFailed( F("isWon() is wrong"), 0 ) );
+  }
+
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+template <uint8_t WIDTH, uint8_t HEIGHT>
+bool BasicGame<WIDTH, HEIGHT>::selfCheckFailed( const __FlashStringHelper *reason, const uint8_t position )
+{
+#if defined(HAVE_SERIAL_HEX)
+  Serial.print( F("*** self check failed: ") );
+  Serial.print( reason );
+  Serial.print( F(" at ") );
+  Serial.print( position % levelWidth ); Serial.print( F(",") ); Serial.print( position / levelWidth );
+  Serial.println( F(" ***") );
+  serialPrintLevel();
+#endif
+  return( false );
+}
+#endif
+
+/*--------------------------------------------------------*/
+// uncovers the tile at x,y (the player's action) and
+// switches to 'boom' or 'gameWon' if required
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::uncoverAndUpdateStatus( const int8_t x, const int8_t y )
+{
+  // uncover this cell and all adjacent cells (if this cell is empty)
+  PROFILE_BEGIN( PROFILE_UNCOVER );
+  bool boom = uncoverCells( x, y );
+  PROFILE_END( PROFILE_UNCOVER );
+
+  if ( !boom )
+  {
+    // are all non mine fields uncovered?
+    if ( isWon() )
+    {
+      // game won!
+      setStatus( Status::gameWon );
+    }
+  }
+  else
+  {
+    // something bad did happen...
+    setStatus( Status::boom );
+  }
+
+#ifdef GAME_SELF_CHECK
+  checkInvariants();
+#endif
+}
+
+#ifdef PROGRESSIVE_REVEAL
+/*--------------------------------------------------------*/
+// Like 'uncoverAndUpdateStatus()', but only the player's cell is uncovered,
+// 'continueUncover()' performs the flood fill in slices (one per frame).
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::beginUncover( const int8_t x, const int8_t y )
+{
+  uint8_t result = uncoverFirstCell( x, y );
+
+  // something bad did happen...
+  if ( result == BOMB ) { setStatus( Status::boom ); }
+
+  uncovering = ( result == HIDDEN );
+}
+
+/*--------------------------------------------------------*/
+// Uncovers the next REVEAL_CELLS_PER_FRAME cells, the game is won
+// if all non mine fields are uncovered after the last slice.
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::continueUncover()
+{
+  if ( !uncovering ) { return; }
+
+  PROFILE_BEGIN( PROFILE_UNCOVER );
+  uncovering = uncoverStep( REVEAL_CELLS_PER_FRAME );
+  PROFILE_END( PROFILE_UNCOVER );
+
+  if ( !uncovering )
+  {
+  #ifdef GAME_SELF_CHECK
+    checkInvariants();
+  #endif
+    if ( isWon() ) { setStatus( Status::gameWon ); }
+  }
+}
+
+#endif
+
 /*--------------------------------------------------------*/
 // uncover selected tiles after ***BOOM***
-void Game::uncoverCells( uint8_t mask /*= 0xff*/ )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::uncoverCells( uint8_t mask /*= 0xff*/ )
 {
   for ( uint8_t y = 0; y < levelHeight; y++ )
   {
@@ -244,23 +535,30 @@ void Game::uncoverCells( uint8_t mask /*= 0xff*/ )
 // The game is won, if all fields except the mines are uncovered,
 // thus the number of covered fields is less or equal to the number of mines.
 // (Less, because there might be a "continue" play mode)
-bool Game::isWon()
+template <uint8_t WIDTH, uint8_t HEIGHT>
+bool BasicGame<WIDTH, HEIGHT>::isWon()
 {
   return( countCellsWithAttribute( HIDDEN ) <= minesCount );
 }
 
 /*--------------------------------------------------------*/
 // toggle flag - but only on covered tiles
-void Game::toggleFlag( const int8_t x, const int8_t y )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::toggleFlag( const int8_t x, const int8_t y )
 {
   uint8_t cellValue = getCellValue( x, y );
   if ( cellValue & HIDDEN )
   {
     setCellValue( x, y, cellValue ^ FLAG );
   }
+
+#ifdef GAME_SELF_CHECK
+  checkInvariants();
+#endif
 }
 
-bool Game::hasFlag( const int8_t x, const int8_t y )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+bool BasicGame<WIDTH, HEIGHT>::hasFlag( const int8_t x, const int8_t y )
 {
   return getCellValue(x, y) & FLAG;
 }
@@ -268,7 +566,8 @@ bool Game::hasFlag( const int8_t x, const int8_t y )
 /*--------------------------------------------------------*/
 // We can safely count the 3x3 neighbourhood, because the center
 // position is not a bomb - otherwise we would already be dead ;)
-uint8_t Game::countNeighbors( const int8_t x, const int8_t y )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+uint8_t BasicGame<WIDTH, HEIGHT>::countNeighbors( const int8_t x, const int8_t y )
 {
   uint8_t neighbors = 0;
 
@@ -288,7 +587,8 @@ uint8_t Game::countNeighbors( const int8_t x, const int8_t y )
 
 /*--------------------------------------------------------*/
 // Access function to handle border management
-void Game::setCellValue( const int8_t x, const int8_t y, const uint8_t value )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::setCellValue( const int8_t x, const int8_t y, const uint8_t value )
 {
   if ( isPositionValid( x, y ) )
   {
@@ -299,7 +599,8 @@ void Game::setCellValue( const int8_t x, const int8_t y, const uint8_t value )
 
 /*--------------------------------------------------------*/
 // Access function to handle border management
-uint8_t Game::getCellValue( const int8_t x, const int8_t y )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+uint8_t BasicGame<WIDTH, HEIGHT>::getCellValue( const int8_t x, const int8_t y )
 {
   uint8_t cellValue = EMPTY;
 
@@ -312,7 +613,8 @@ uint8_t Game::getCellValue( const int8_t x, const int8_t y )
 }
 
 /*--------------------------------------------------------*/
-bool Game::isPositionValid( const int8_t x, const int8_t y )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+bool BasicGame<WIDTH, HEIGHT>::isPositionValid( const int8_t x, const int8_t y )
 {
   return(    ( x >= 0 ) && ( x < levelWidth )
           && ( y >= 0 ) && ( y < levelHeight ) );
@@ -320,7 +622,8 @@ bool Game::isPositionValid( const int8_t x, const int8_t y )
 
 
 /*--------------------------------------------------------*/
-void Game::setCursorPosition( const uint8_t x, const uint8_t y )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::setCursorPosition( const uint8_t x, const uint8_t y )
 {
   // store new positions
   cursorX = x;
@@ -338,7 +641,8 @@ void Game::setCursorPosition( const uint8_t x, const uint8_t y )
 
 /*--------------------------------------------------------*/
   // clear level - just in case
-void Game::clearLevel()
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::clearLevel()
 {
   minesCount = 0;
   flagsCount = 0;
@@ -347,11 +651,71 @@ void Game::clearLevel()
   memset( levelData, EMPTY, MAX_GAME_COLS * MAX_GAME_ROWS );
 }
 
+/*--------------------------------------------------------*/
+// Serializes the game state byte by byte (for saving to EEPROM):
+//   status, mines, flags, clicks (16 bit), cursor x, y, seed (32 bit), level data
+// The level data is stored without the cursor bit, moving the cursor only
+// changes the cursor position.
+template <uint8_t WIDTH, uint8_t HEIGHT>
+uint8_t BasicGame<WIDTH, HEIGHT>::getStateByte( const uint8_t index )
+{
+  switch ( index )
+  {
+    case 0:  return( uint8_t( status ) );
+    case 1:  return( minesCount );
+    case 2:  return( flagsCount );
+    case 3:  return( uint8_t( clicksCount ) );
+    case 4:  return( uint8_t( clicksCount >> 8 ) );
+    case 5:  return( cursorX );
+    case 6:  return( cursorY );
+    case 7:
+    case 8:
+    case 9:
+    case 10: return( uint8_t( seed >> ( ( index - 7 ) * 8 ) ) );
+    default: return( levelData[index - 11] & DATA_MASK );
+  }
+}
+
+/*--------------------------------------------------------*/
+// counterpart of 'getStateByte()'
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::setStateByte( const uint8_t index, const uint8_t value )
+{
+  switch ( index )
+  {
+    case 0:  status = Status( value ); break;
+    case 1:  minesCount = value; break;
+    case 2:  flagsCount = value; break;
+    case 3:  clicksCount = ( clicksCount & 0xff00 ) | value; break;
+    case 4:  clicksCount = ( clicksCount & 0x00ff ) | ( uint16_t( value ) << 8 ); break;
+    case 5:  cursorX = value; break;
+    case 6:  cursorY = value; break;
+    case 7:
+    case 8:
+    case 9:
+    case 10:
+    {
+      uint8_t shift = ( index - 7 ) * 8;
+      seed = ( seed & ~( 0xffL << shift ) ) | ( long( value ) << shift );
+      break;
+    }
+    default: levelData[index - 11] = value; break;
+  }
+}
+
 /*--------------------------------------------------------*/
 // dump the level to the serial port
-void Game::serialPrintLevel()
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::serialPrintLevel()
 {
-#if defined(HAVE_SERIAL_HEX)
+#if defined(SERIAL_BINARY_FRAMES)
+  uint16_t clicks = clicksCount;
+  uint8_t header[] = { uint8_t( status ), levelWidth, levelHeight, minesCount,
+                       getFlaggedTilesCount(), getHiddenTilesCount(),
+                       uint8_t( clicks ), uint8_t( clicks >> 8 ),
+                       uint8_t( seed ), uint8_t( seed >> 8 ), uint8_t( seed >> 16 ), uint8_t( seed >> 24 ) };
+  serialSendFrame( SERIAL_FRAME_LEVEL, header, sizeof( header ), levelData, levelWidth * levelHeight );
+#elif defined(HAVE_SERIAL_HEX)
   Serial.print( F("markedMines = ") ); Serial.print( getFlaggedTilesCount() );
   Serial.print( F(", hiddenTiles = ") ); Serial.print( getHiddenTilesCount() );
   Serial.print( F(", clicksCount = ") ); Serial.print( getClicksCount() );
@@ -368,9 +732,13 @@ void Game::serialPrintLevel()
 
 /*--------------------------------------------------------*/
 // prints the current game status to serial output
-void Game::serialPrintGameStatus()
+template <uint8_t WIDTH, uint8_t HEIGHT>
+void BasicGame<WIDTH, HEIGHT>::serialPrintGameStatus()
 {
-#if defined(HAVE_SERIAL_HEX)
+#if defined(SERIAL_BINARY_FRAMES)
+  uint8_t header[] = { uint8_t( status ) };
+  serialSendFrame( SERIAL_FRAME_GAME_STATUS, header, sizeof( header ), nullptr, 0 );
+#elif defined(HAVE_SERIAL_HEX)
   switch( status )
   {
     case Status::intro:
@@ -402,7 +770,8 @@ void Game::serialPrintGameStatus()
 }
 
 /*--------------------------------------------------------*/
-uint8_t Game::countCellsWithAttribute( uint8_t mask )
+template <uint8_t WIDTH, uint8_t HEIGHT>
+uint8_t BasicGame<WIDTH, HEIGHT>::countCellsWithAttribute( uint8_t mask )
 {
   uint8_t count = 0;
 
@@ -417,3 +786,12 @@ uint8_t Game::countCellsWithAttribute( uint8_t mask )
 
   return( count );
 }
+
+/*--------------------------------------------------------*/
+// the level sizes: only 'Game' on the device, both for the host tools
+#if !defined(GAME_VARIABLE_SIZE) || !defined(__AVR__)
+  template class BasicGame<MAX_GAME_COLS, MAX_GAME_ROWS>;
+#endif
+#if defined(GAME_VARIABLE_SIZE) || !defined(__AVR__)
+  template class BasicGame<0, 0>;
+#endif
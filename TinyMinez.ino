@@ -31,6 +31,13 @@
 // perform a serial screenshot if this condition is true:
 //#define _SERIAL_SCREENSHOT_TRIGGER_CONDITION_ ( isRightPressed() )
 
+// record the seed and all player actions to EEPROM (see Replay.h)
+//#define _ENABLE_REPLAY_RECORDER_
+// render the rules and the 'game won' message as zoomed text instead of bitmaps (saves ~400 bytes flash)
+#define _ENABLE_TEXT_SCREENS_
+// only play levels which can be solved without guessing (seeds from 'seedBank.h', 128 bytes flash)
+//#define _ENABLE_SEED_BANK_
+
 #include <Arduino.h>
 #include <util/delay.h>
 
@@ -44,26 +51,55 @@
 #include "RLEdecompression.h"
 #include "TinyMinezGame.h"
 #include "Selection.h"
+#include "Replay.h"
+#include "GameStorage.h"
+#include "profiler.h"
+#include "scratchBuffer.h"
+#include "memoryMonitor.h"
+#include "tinyRandom.h"
+#ifdef _ENABLE_SEED_BANK_
+  #include "seedBank.h"
+#endif
 
 const uint8_t KEY_DELAY = 100;
-const uint8_t FLAG_DELAY = 100;
+// the pause after a player's action
+const uint8_t KEY_DELAY_FRAMES = KEY_DELAY / FRAME_TIME_MS;
+// fire has to be pressed longer than this for setting a flag (~400ms)
+const uint8_t FLAG_PRESS_FRAMES = 400 / FRAME_TIME_MS;
 
 // the mines per board for the 4 difficulties
 const uint8_t mineDifficulty[] PROGMEM = { 5, 10, 15, 20 };
 
+#ifdef _ENABLE_TEXT_SCREENS_
+// message screens (4 lines of up to 16 characters, see 'pgm_printZoomedText()')
+const char rulesText[] PROGMEM = "FIND ALL MINES!\n\nSHORT: UNCOVER\nLONG: SET FLAG";
+const char gameWonText[] PROGMEM = "\nCONGRATULATIONS!\nYOU SAVED\nTHE DAY!";
+#endif
+
 // the game object containing all logic and data
 Game game;
 
 // the difficulty selection
 Selection selection( checked, unchecked, 16, 6, 0x01 );
 
-// it's difficult to spot the cursor, so let it flash (frame time is ~50ms)
+#ifdef _ENABLE_REPLAY_RECORDER_
+// input recorder for reproducing a game
+Replay replay;
+#endif
+
+// it's difficult to spot the cursor, so let it flash (frame time is ~48ms)
 const uint8_t CursorMaxFlashCount = 24;
 // flash if count is greater or equal the threshold
 const uint8_t cursorFlashThreshold = CursorMaxFlashCount / 2;
 // increase this counter on every display;
 uint8_t cursorFlashCount = 0;
 
+// the level for the highlighted difficulty is created in advance (see 'prepareLevel()')
+bool levelPrepared = false;
+
+// stirred with the player's timing, becomes the seed of the next level
+uint16_t seedState;
+
 /*--------------------------------------------------------*/
 void setup()
 {
@@ -71,6 +107,16 @@ void setup()
   InitTinyJoypad();
   // perform display initialization
   InitDisplay();
+  // the first seed is taken from the hardware
+  seedState = getHardwareEntropy();
+  // now the watchdog is free to drive the frame timing
+  InitFrameTimer();
+  // start the section timer (if PROFILER_ENABLED is defined in profiler.h)
+  PROFILE_INIT();
+#ifdef _ENABLE_GAME_STORAGE_
+  // find the last saved game
+  gameStorage.begin( game );
+#endif
 }
 
 /*--------------------------------------------------------*/
@@ -78,14 +124,23 @@ void loop()
 {
   game.setStatus( Status::intro );
 
+#ifdef _ENABLE_GAME_STORAGE_
+  // continue an interrupted game (this sets the status to 'playGame')
+  if ( gameStorage.restore() )
+  {
+    // select the matching difficulty (for the game won screen)
+    for ( uint8_t n = 0; n < sizeof( mineDifficulty ); n++ )
+    {
+      if ( pgm_read_byte( mineDifficulty + n ) == game.getMinesCount() ) { selection.setSelection( n ); }
+    }
+  }
+#endif
+
   uint8_t count = 0;
 
   // game main loop
   while ( true )
   {
-    // always incement seed
-    game.incrementSeed();
-
     switch ( game.getStatus() )
     {
       /////////////////////////////
@@ -93,20 +148,29 @@ void loop()
       case Status::intro:
       case Status::rules:
       {
+        // the screen only changes when switching between title and rules
+        bool redraw = ( ( count & 0x7f ) == 0 );
+
         // alternate between title screen and rules
         game.setStatus( ( count++ < 128 ) ? Status::intro : Status::rules );
 
         // display intro screen
-        Tiny_Flip( false );
+        if ( redraw ) { Tiny_Flip( false ); }
+
+        // the player's timing makes every game different
+        stirSeed();
 
         // check if button pressed
         if ( isFirePressed() )
         {
           game.setStatus( Status::difficultySelection );
 
-          // increment seed while waiting - this way we get a good enough random seed
-          while ( isFirePressed() ) { game.incrementSeed(); }
+          // wait until the button is released
+          waitForFireButtonReleased();
         }
+
+        // sleep until the next frame
+        waitForNextFrame();
         break;
       }
 
@@ -122,6 +186,9 @@ void loop()
 
         do
         {
+          // sleep until the next frame
+          waitForNextFrame();
+
           // check for user actions
           if ( isUpPressed() ) 
           { 
@@ -142,19 +209,21 @@ void loop()
             blip5();
             // display new selection
             Tiny_Flip( false );
+            // create the level for the new difficulty
+            prepareLevel();
             // wait until the button is released
             waitUntilButtonsReleased( KEY_DELAY );
             // action processed
             userAction = false;
           }
 
-          // help the RNG
-          game.incrementSeed();
+          // the player's timing makes every game different
+          stirSeed();
 
         } while( !isFirePressed() );
 
-        // increment seed while waiting - this way we get a good enough random seed
-        while ( isFirePressed() ) { game.incrementSeed(); }
+        // wait until the button is released
+        waitForFireButtonReleased();
 
         // prepare the game
         game.setStatus( Status::prepareGame );
@@ -169,15 +238,21 @@ void loop()
         // acknowledge the pressed button
         blip5();
 
-        // hide the selected number of mines
-        uint8_t numberOfMines = pgm_read_byte( mineDifficulty + selection.getSelection() );
-
-        // create a new level depending on the difficulty (TODO)
-        game.createLevel( numberOfMines );
+        // the level was usually created during the difficulty selection
+        if ( !levelPrepared ) { prepareLevel(); }
+        levelPrepared = false;
+      #ifdef _ENABLE_REPLAY_RECORDER_
+        // store the seed (and the difficulty) for replaying this game
+        replay.startRecording( game );
+      #endif
         // dump the level to serial
         game.serialPrintLevel();
         // start the game
         game.setStatus( Status::playGame );
+      #ifdef _ENABLE_GAME_STORAGE_
+        // save the new board
+        gameStorage.requestSave();
+      #endif
         break;
       }
 
@@ -186,11 +261,18 @@ void loop()
       case Status::playGame:
       {
         bool playerAction = false;
+        // force the first redraw
+        bool redraw = true;
 
         while ( ( game.getStatus() != Status::gameWon ) && ( game.getStatus() != Status::boom ) )
         {
-          // increase random seed
-          game.incrementSeed();
+          // sleep until the next frame
+          waitForNextFrame();
+
+        #if defined(_ENABLE_REPLAY_RECORDER_) || defined(_ENABLE_GAME_STORAGE_)
+          // no action for the replay yet
+          uint8_t replayAction = Replay::REPLAY_MOVE;
+        #endif
 
           // get current cursor position
           uint8_t cursorX = game.getCursorX();
@@ -221,7 +303,8 @@ void loop()
             // wait a moment
             playerAction = true;
           }
-          if ( isFirePressed() )
+          // the board can't be changed while the flood fill is running
+          if ( isFirePressed() && !game.isUncovering() )
           {
             // TODO - remove long press if we have an extra button?
             uint8_t count = 0;
@@ -229,17 +312,20 @@ void loop()
             do
             {
               // wait until the button is released
-              _delay_ms( FLAG_DELAY );
+              waitForNextFrame();
               // count this!
               if ( count < 255 ) { count++; }
             // wait unit the button is released
             } while ( isFirePressed() );
 
-            // was fire pressed longer than 3 rounds(~400ms)?
-            if ( count > 3 )
+            // was fire pressed longer than ~400ms?
+            if ( count > FLAG_PRESS_FRAMES )
             {
               // set or remove a flag symbol
               game.toggleFlag( cursorX, cursorY );
+            #if defined(_ENABLE_REPLAY_RECORDER_) || defined(_ENABLE_GAME_STORAGE_)
+              replayAction = Replay::REPLAY_FLAG;
+            #endif
             }
             else
             {
@@ -247,30 +333,26 @@ void loop()
                 blip3();
               } else {
               // uncover this cell and all adjacent cells (if this cell is empty)
-              if ( !game.uncoverCells( cursorX, cursorY ) )
-              {
-                // are all non mine fields uncovered?
-                if ( game.isWon() ) 
-                { 
-                  // game won!
-                  game.setStatus( Status::gameWon );
-                }
-              }
-              else
-              {
-                // something bad did happen...
-                game.setStatus( Status::boom );
-              }
+              #ifdef PROGRESSIVE_REVEAL
+                game.beginUncover( cursorX, cursorY );
+              #else
+                game.uncoverAndUpdateStatus( cursorX, cursorY );
+              #endif
               }
+            #if defined(_ENABLE_REPLAY_RECORDER_) || defined(_ENABLE_GAME_STORAGE_)
+              replayAction = Replay::REPLAY_UNCOVER;
+            #endif
             }
             // wait a moment
             playerAction = true;
           }
-          else if ( isFlagPressed() )
+          else if ( isFlagPressed() && !game.isUncovering() )
           {
              // set or remove a flag symbol
               game.toggleFlag( cursorX, cursorY );
-              _delay_ms( FLAG_DELAY );
+            #if defined(_ENABLE_REPLAY_RECORDER_) || defined(_ENABLE_GAME_STORAGE_)
+              replayAction = Replay::REPLAY_FLAG;
+            #endif
               // wait a moment
               playerAction = true;
           }
@@ -283,24 +365,59 @@ void loop()
           // update cursor flash count
           cursorFlashCount++;
           if ( cursorFlashCount >= CursorMaxFlashCount ) { cursorFlashCount = 0; }
+          // reset cursor to visible after any action
+          if ( playerAction ) { cursorFlashCount = 0; }
+          // the cursor appears or disappears?
+          if ( ( cursorFlashCount == 0 ) || ( cursorFlashCount == cursorFlashThreshold ) ) { redraw = true; }
+
+        #ifdef _ENABLE_REPLAY_RECORDER_
+          // store movement and action in the replay log
+          replay.recordEvent( replayAction, cursorX, cursorY );
+        #endif
 
           // set cursor to the new position
           game.setCursorPosition( cursorX, cursorY );
 
-          // draw board
-          Tiny_Flip( false );
+        #ifdef PROGRESSIVE_REVEAL
+          // uncover the next cells of the flood fill
+          if ( game.isUncovering() )
+          {
+            game.continueUncover();
+            redraw = true;
+          #ifdef _ENABLE_GAME_STORAGE_
+            // the board is saved when the fill is complete
+            if ( !game.isUncovering() ) { gameStorage.requestSave(); }
+          #endif
+          }
+        #endif
+
+        #ifdef _ENABLE_GAME_STORAGE_
+          // the board has changed, save it in the background
+          if ( ( replayAction != Replay::REPLAY_MOVE ) && !game.isUncovering() ) { gameStorage.requestSave(); }
+          // verify and commit what the interrupt has written
+          gameStorage.update();
+        #endif
 
-          // only delay if there were any changes (important for getting a good seed)
+          // draw board (only if anything has changed)
+          if ( redraw || playerAction )
+          {
+            Tiny_Flip( false );
+            redraw = false;
+          }
+
+          // only delay if there were any changes
           if ( playerAction )
           {
-            // reset cursor to visible
-            cursorFlashCount = 0;
             // no forced update required
             playerAction = false;
             // wait a moment
-            _delay_ms( KEY_DELAY );
+            waitFrames( KEY_DELAY_FRAMES );
           }
         }
+      #ifdef _ENABLE_GAME_STORAGE_
+        // commit the final state, a finished game is not restored
+        while ( gameStorage.isBusy() ) {}
+      #endif
         break;
       }
 
@@ -312,24 +429,31 @@ void loop()
         failingSound();
 
         // display ***BOOM*** screen and flash 
-        for ( uint8_t flash = 0; flash < 10; flash++ ) { Tiny_Flip( flash == 0 ); _delay_ms( 100 ); }
+        for ( uint8_t flash = 0; flash < 10; flash++ ) { Tiny_Flip( flash == 0 ); waitFrames( 100 / FRAME_TIME_MS ); }
 
         // uncover all mines
         game.uncoverCells( BOMB );
         game.setStatus( Status::gameOver );
+        // timing and memory statistics of this game
+        reportStatistics();
+
+        // force the first redraw
+        cursorFlashCount = 0;
 
         while ( !isFirePressed() )
         { 
-          // show the board with all tiles uncoverted
-          Tiny_Flip( true );
+          // show the board with all tiles uncoverted (only if the cursor appears or disappears)
+          if ( ( cursorFlashCount == 0 ) || ( cursorFlashCount == cursorFlashThreshold ) ) { Tiny_Flip( true ); }
           // update cursor flash count
           cursorFlashCount++;
           if ( cursorFlashCount >= CursorMaxFlashCount ) { cursorFlashCount = 0; }
+          // sleep until the next frame
+          waitForNextFrame();
         }
 
         // wait until fire is released
-        while ( isFirePressed() );
-        _delay_ms( KEY_DELAY );
+        waitForFireButtonReleased();
+        waitFrames( KEY_DELAY_FRAMES );
 
         // acknowledge the button
         blip5();
@@ -346,6 +470,8 @@ void loop()
       {
         // display game won screen
         Tiny_Flip( false );
+        // timing and memory statistics of this game
+        reportStatistics();
         // play a tune
         successSound();
         // wait for button
@@ -366,19 +492,49 @@ void loop()
 /*--------------------------------------------------------*/
 void Tiny_Flip( bool invert )
 {
+  PROFILE_BEGIN( PROFILE_RENDER );
+
   Status gameStatus = game.getStatus();
 
-  // prepare text buffer for statistics (only displayed during the game)
-  clearTextBuffer();
-  uint8_t *textBuffer = getTextBuffer();
+  // message screens are displayed from the text buffer
+  const char *message = nullptr;
+#ifdef _ENABLE_TEXT_SCREENS_
+  if ( gameStatus == Status::rules ) { message = rulesText; }
+  else if ( ( gameStatus == Status::gameWon ) && ( selection.getSelection() < 3 ) ) { message = gameWonText; }
+#endif
 
-  // prepare statistics when game is running
-  convertValueToDigits( game.getFlaggedTilesCount(), textBuffer + 1 + 1 * 4 );
-  convertValueToDigits( game.getHiddenTilesCount(), textBuffer + 1 + 4 * 4 );
-  convertValueToDigits( game.getClicksCount(), textBuffer + 1 + 7 * 4 );
+  // the text buffer shares the scratch buffer with the bitmap decompression,
+  // so it's only filled for the board (statistics) and message screens
+  bool textInUse = ( message != nullptr ) || ( gameStatus == Status::playGame ) || ( gameStatus == Status::gameOver );
+  if ( textInUse )
+  {
+    uint8_t *textBuffer = scratchAcquire( SCRATCH_TEXT );
+    clearTextBuffer();
+
+    if ( message != nullptr )
+    {
+      pgm_printZoomedText( message );
+    }
+    else
+    {
+      // prepare statistics when game is running
+      convertValueToDigits( game.getFlaggedTilesCount(), textBuffer + 1 + 1 * 4 );
+      convertValueToDigits( game.getHiddenTilesCount(), textBuffer + 1 + 4 * 4 );
+      convertValueToDigits( game.getClicksCount(), textBuffer + 1 + 7 * 4 );
+    #if defined(PROFILER_ENABLED) && defined(PROFILER_OVERLAY)
+      // average busy time per frame in ms
+      convertValueToDigits( profilerGetAverage( PROFILE_FRAME ) / PROFILER_TICKS_PER_MS, textBuffer + 1 + 2 * 4 );
+    #endif
+    #if defined(MEMORY_MONITOR_ENABLED) && defined(MEMORY_MONITOR_OVERLAY)
+      // untouched stack bytes (limited to 99), a damaged 'levelData' shows '00'
+      uint16_t headroom = game.isLevelIntact() ? memoryMonitorStackHeadroom() : 0;
+      convertValueToDigits( ( headroom < 99 ) ? headroom : 99, textBuffer + 1 + 5 * 4 );
+    #endif
+    }
+  }
 
   // optional bitmap buffer pointer
-  uint8_t *compressedBitmap;
+  uint8_t *compressedBitmap = nullptr;
 
   // only invert cursor if flash count is less than threshold
   uint8_t cursor = ( cursorFlashCount < cursorFlashThreshold ) ? 0xff : 0x00;
@@ -386,95 +542,124 @@ void Tiny_Flip( bool invert )
   // there are 8 rows of 8 pixels each
   for ( uint8_t y = 0; y < 8; y++)
   {
-    TinyFlip_PrepareDisplayRow( y );
-
-    switch ( gameStatus )
+    // a row may be rendered twice (see '_ENABLE_PAGE_HASHES_'), so remember where its bitmap starts
+    uint8_t *rowBitmap = compressedBitmap;
+    do
     {
-      ///////////////////////////
-      // display a compressed bitmap
-      case Status::intro:
-      case Status::rules:
-      case Status::difficultySelection:
-      case Status::prepareGame:
-      case Status::boom:
-      case Status::gameWon:
+      // the second pass starts at the same position of the bitmap
+      compressedBitmap = rowBitmap;
+
+      TinyFlip_PrepareDisplayRow( y );
+
+      switch ( gameStatus )
       {
-        // select bitmap
-        if ( y == 0 )
+        ///////////////////////////
+        // display a compressed bitmap
+        case Status::intro:
+        case Status::rules:
+        case Status::difficultySelection:
+        case Status::prepareGame:
+        case Status::boom:
+        case Status::gameWon:
         {
-          switch( gameStatus )
+        #ifdef _ENABLE_TEXT_SCREENS_
+          if ( message != nullptr )
           {
-            case Status::intro:
-            case Status::prepareGame:
-             compressedBitmap = TitleScreen; break;
-            case Status::rules:
-              compressedBitmap = Rules; break;
-            case Status::difficultySelection:
-             compressedBitmap = difficultySelection; break;
-            case Status::boom:
-             compressedBitmap = BOOM; break;
-            case Status::gameWon:
-             compressedBitmap = ( selection.getSelection() < 3 ) ? game_won : AWESOME; break;
+            // display the zoomed text line
+            uint8_t xorValue = invert ? 0xff : 0x00;
+            for ( uint8_t x = 0; x < 128; x++ ) { TinyFlip_SendPixels( displayZoomedText( x, y ) ^ xorValue ); }
+            break;
           }
-        }
+        #endif
 
-        // display the full line
-        compressedBitmap = displayBitmapRow( y, compressedBitmap, invert );
-        break;
-      }
+          // select bitmap
+          if ( y == 0 )
+          {
+            switch( gameStatus )
+            {
+              case Status::intro:
+              case Status::prepareGame:
+               compressedBitmap = TitleScreen; break;
+            #ifndef _ENABLE_TEXT_SCREENS_
+              case Status::rules:
+                compressedBitmap = Rules; break;
+            #endif
+              case Status::difficultySelection:
+               compressedBitmap = difficultySelection; break;
+              case Status::boom:
+               compressedBitmap = BOOM; break;
+              case Status::gameWon:
+            #ifdef _ENABLE_TEXT_SCREENS_
+               compressedBitmap = AWESOME; break;
+            #else
+               compressedBitmap = ( selection.getSelection() < 3 ) ? game_won : AWESOME; break;
+            #endif
+            }
+          }
 
-      ///////////////////////////
-      // display the board, if the game is over,
-      // the board will be inverted
-      case Status::playGame:
-      case Status::gameOver:
-      {
-        // invert image?
-        uint8_t invertValue = invert ? 0xff : 0x00;
+          // display the full line
+          compressedBitmap = displayBitmapRow( y, compressedBitmap, invert );
+          break;
+        }
 
-        // the first 96 columns are used to display the dungeon
-        for ( uint8_t x = 0; x < 96; x++ )
+        ///////////////////////////
+        // display the board, if the game is over,
+        // the board will be inverted
+        case Status::playGame:
+        case Status::gameOver:
         {
-          uint8_t spriteColumn = x & 0x07;
-          uint8_t cellValue = game.getCellValue( x >> 3, y );
+          // invert image?
+          uint8_t invertValue = invert ? 0xff : 0x00;
 
-          uint8_t pixels = getSpriteData( cellValue, spriteColumn );
-          // invert the tile with the cursor above it
-          if ( cellValue & 0x80 ) { pixels ^= cursor; }
-          // invert anyway?
-          pixels ^= invertValue;
+          // the first 96 columns are used to display the dungeon
+          for ( uint8_t x = 0; x < 96; x++ )
+          {
+            uint8_t spriteColumn = x & 0x07;
+            uint8_t cellValue = game.getCellValue( x >> 3, y );
 
-          TinyFlip_SendPixels( pixels );
-        } // for x
+            uint8_t pixels = getSpriteData( cellValue, spriteColumn );
+            // invert the tile with the cursor above it
+            if ( cellValue & 0x80 ) { pixels ^= cursor; }
+            // invert anyway?
+            pixels ^= invertValue;
 
-        // display the dashboard here
-        for ( uint8_t x = 0; x < 32; x++)
-        {
-          uint8_t pixels = pgm_read_byte( dashBoard + x + y * 32 )
-                         | displayText( x, y );
-          TinyFlip_SendPixels( pixels );
+            TinyFlip_SendPixels( pixels );
+          } // for x
+
+          // display the dashboard here
+          for ( uint8_t x = 0; x < 32; x++)
+          {
+            uint8_t pixels = pgm_read_byte( dashBoard + x + y * 32 )
+                           | displayText( x, y );
+            TinyFlip_SendPixels( pixels );
+          }
+          break;
         }
-        break;
-      }
 
-      ///////////////////////////
-      // this should never happen
-      default:
-      {
-      #if !(defined(__AVR_ATtiny85__) || defined(ARDUINO_AVR_ATTINYX4))
-        Serial.println( F("*** Tiny_Flip() : default branch hit - did you forget something? ***") );
-        while( 1 );
-        break;
-      #endif
-      }
-    } // switch
+        ///////////////////////////
+        // this should never happen
+        default:
+        {
+        #if !(defined(__AVR_ATtiny85__) || defined(ARDUINO_AVR_ATTINYX4))
+          Serial.println( F("*** Tiny_Flip() : default branch hit - did you forget something? ***") );
+          while( 1 );
+          break;
+        #endif
+        }
+      } // switch
     
-    TinyFlip_FinishDisplayRow();
+      TinyFlip_FinishDisplayRow();
+
+    } while ( TinyFlip_PageChanged( y ) );
   } // for y
 
+  if ( textInUse ) { scratchRelease( SCRATCH_TEXT ); }
+
   // display the whole screen at once
   TinyFlip_DisplayBuffer();
 
+  PROFILE_END( PROFILE_RENDER );
+
   #ifdef _ENABLE_SERIAL_SCREENSHOT_
     if ( _SERIAL_SCREENSHOT_TRIGGER_CONDITION_ )
     {
@@ -484,6 +669,44 @@ void Tiny_Flip( bool invert )
   #endif
 }
 
+/*--------------------------------------------------------*/
+// Stirs the player's timing into the seed. Cheap enough for every idle frame
+// of the intro and the difficulty selection.
+void stirSeed()
+{
+  seedState = xorshift16( seedState ^ getTimerJitter() );
+}
+
+/*--------------------------------------------------------*/
+// Creates the level for the highlighted difficulty. Called when the selection
+// changes, so the level is ready when the player confirms.
+void prepareLevel()
+{
+  // hide the selected number of mines
+  uint8_t numberOfMines = pgm_read_byte( mineDifficulty + selection.getSelection() );
+
+#ifdef _ENABLE_SEED_BANK_
+  // the stirred state selects one of the levels generated by 'host/seedBank.cpp'
+  uint8_t index = uint8_t( seedState >> 8 ) & ( SEED_BANK_SIZE - 1 );
+  game.setSeed( pgm_read_word( &seedBank[selection.getSelection()][index] ) );
+#else
+  game.setSeed( seedState );
+#endif
+  // create a new level depending on the difficulty
+  game.createLevel( numberOfMines );
+  levelPrepared = true;
+}
+
+/*--------------------------------------------------------*/
+// Prints the profiler and memory monitor results (debug builds only)
+void reportStatistics()
+{
+  PROFILE_REPORT();
+#ifdef MEMORY_MONITOR_ENABLED
+  memoryMonitorReport( game.isLevelIntact() );
+#endif
+}
+
 /*--------------------------------------------------------*/
 // Displays the row of the given bitmap and inverts it if required
 // The bitmap is expected to be RLE encoded. The function returns
@@ -499,8 +722,8 @@ uint8_t* displayBitmapRow( const uint8_t y, const uint8_t *bitmap, const bool in
     overlay = &selection;
   }
 
-  // we will repurpose the text buffer to save valuable RAM
-  uint8_t *chunkBuffer = getTextBuffer();
+  // decompress into the scratch buffer to save valuable RAM
+  uint8_t *chunkBuffer = scratchAcquire( SCRATCH_BITMAP_ROW );
 
   // uncompress chunk and save next address
   uint8_t *render = pgm_RLEdecompress( bitmap, chunkBuffer, 128 );
@@ -518,6 +741,8 @@ uint8_t* displayBitmapRow( const uint8_t y, const uint8_t *bitmap, const bool in
     TinyFlip_SendPixels( pixels );
   } // for x
 
+  scratchRelease( SCRATCH_BITMAP_ROW );
+
   // return the current decompression pointer
   return( render );
 }
@@ -557,7 +782,13 @@ uint8_t getSpriteData( uint8_t cellValue, uint8_t spriteColumn )
 void waitForFireButtonPressedAndReleased()
 {
   // wait until fire is pressed
-  while ( !isFirePressed() ) { game.incrementSeed(); }
+  while ( !isFirePressed() ) { waitForNextFrame(); }
   // wait until fire is released
-  while ( isFirePressed() ) { game.incrementSeed(); }
+  waitForFireButtonReleased();
+}
+
+/*--------------------------------------------------------*/
+void waitForFireButtonReleased()
+{
+  while ( isFirePressed() ) { waitForNextFrame(); }
 }
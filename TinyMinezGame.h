@@ -1,9 +1,37 @@
 #pragma once
 
 #include <Arduino.h>
+#include "memoryMonitor.h"
 
-const uint8_t MAX_GAME_COLS = 12;
-const uint8_t MAX_GAME_ROWS = 8;
+// verify the structure of the level after every change (debug boards and host tools, see Game::checkInvariants())
+//#define GAME_SELF_CHECK
+
+// spread the flood fill over several frames, so the uncovering is animated and the
+// game doesn't stall on large empty areas (see Game::beginUncover())
+//#define PROGRESSIVE_REVEAL
+// the number of cells uncovered per frame
+const uint8_t REVEAL_CELLS_PER_FRAME = 6;
+
+// neighbor counts and flood fill with row bitmasks (see bitBoard.h) instead of
+// cell by cell, the masks are temporary (stack), the level data is unchanged
+//#define GAME_BITBOARDS
+
+// the level size is a runtime value instead of a compile time constant (for variable size modes)
+//#define GAME_VARIABLE_SIZE
+
+#if defined(HOST_MAX_GAME_COLS) && defined(HOST_MAX_GAME_ROWS)
+  // larger levels for the host tools (cell indices are 8 bit, so 244 cells at most)
+  const uint8_t MAX_GAME_COLS = HOST_MAX_GAME_COLS;
+  const uint8_t MAX_GAME_ROWS = HOST_MAX_GAME_ROWS;
+  static_assert( HOST_MAX_GAME_COLS * HOST_MAX_GAME_ROWS <= 244, "level too large" );
+#else
+  const uint8_t MAX_GAME_COLS = 12;
+  const uint8_t MAX_GAME_ROWS = 8;
+#endif
+
+#ifdef GAME_BITBOARDS
+  static_assert( MAX_GAME_COLS <= 16, "a row of the level must fit into a bitboard row" );
+#endif
 
 enum
 {
@@ -16,6 +44,9 @@ enum
   DATA_MASK  = 0x7f,
 };
 
+// size of the game state for saving (see Game::getStateByte())
+const uint8_t GAME_STATE_SIZE = 11 + MAX_GAME_COLS * MAX_GAME_ROWS;
+
 enum class Status
 {
   intro,
@@ -28,14 +59,54 @@ enum class Status
   gameWon,
 };
 
-class Game
+// The level size: fixed at compile time (constant strides and loop bounds,
+// 'x + y * levelWidth' is a constant multiply or a shift) or, for <0, 0>,
+// chosen at runtime (e.g. for the host tools).
+template <uint8_t WIDTH, uint8_t HEIGHT> class LevelSize
+{
+  static_assert( ( WIDTH <= MAX_GAME_COLS ) && ( HEIGHT <= MAX_GAME_ROWS ), "level too large" );
+
+protected:
+  static constexpr uint8_t levelWidth = WIDTH;
+  static constexpr uint8_t levelHeight = HEIGHT;
+};
+
+template <uint8_t WIDTH, uint8_t HEIGHT> constexpr uint8_t LevelSize<WIDTH, HEIGHT>::levelWidth;
+template <uint8_t WIDTH, uint8_t HEIGHT> constexpr uint8_t LevelSize<WIDTH, HEIGHT>::levelHeight;
+
+template <> class LevelSize<0, 0>
 {
+protected:
+  LevelSize( uint8_t levelWidth = MAX_GAME_COLS, uint8_t levelHeight = MAX_GAME_ROWS ) : levelWidth( levelWidth ), levelHeight( levelHeight ) {}
+
+  uint8_t   levelWidth;
+  uint8_t   levelHeight;
+};
+
+template <uint8_t WIDTH, uint8_t HEIGHT> class BasicGame : private LevelSize<WIDTH, HEIGHT>
+{
+  using LevelSize<WIDTH, HEIGHT>::levelWidth;
+  using LevelSize<WIDTH, HEIGHT>::levelHeight;
+
 public:
-  Game();
-  Game( uint8_t levelWidth, uint8_t levelHeight );
+  BasicGame();
+  // only for levels with a runtime size (BasicGame<0, 0>)
+  template <uint8_t W = WIDTH> BasicGame( uint8_t levelWidth, uint8_t levelHeight ) : LevelSize<WIDTH, HEIGHT>( levelWidth, levelHeight )
+  {
+    static_assert( W == 0, "the size of this level is fixed" );
+    initialize();
+  }
   
   void      createLevel( uint8_t numOfMines );
   bool      uncoverCells( const int8_t x, const int8_t y /*, bool countClick = true*/ );
+  void      uncoverAndUpdateStatus( const int8_t x, const int8_t y );
+#ifdef PROGRESSIVE_REVEAL
+  void      beginUncover( const int8_t x, const int8_t y );
+  void      continueUncover();
+  bool      isUncovering() { return( uncovering ); }
+#else
+  bool      isUncovering() { return( false ); }
+#endif
   void      uncoverCells( uint8_t mask = 0xff );
   bool      isWon();
   Status    getStatus() { return( status ); }
@@ -51,20 +122,39 @@ public:
   void      setCellValue( const int8_t x, const int8_t y, const uint8_t value );
   uint8_t   getCellValue( const int8_t x, const int8_t y );
   bool      isPositionValid( const int8_t x, const int8_t y );
-  void      incrementSeed() { seed++; }
   long      getSeed() { return( seed ); }
+  void      setSeed( long newSeed ) { seed = newSeed; }
+  uint8_t   getStateByte( const uint8_t index );
+  void      setStateByte( const uint8_t index, const uint8_t value );
   void      serialPrintLevel();
   void      serialPrintGameStatus();
 
+  uint8_t   getMinesCount() { return( minesCount ); }
   uint8_t   getClicksCount() { return( clicksCount ); }
   uint8_t   getFlaggedTilesCount() { return( countCellsWithAttribute( FLAG ) ); }
   uint8_t   getHiddenTilesCount() { return( countCellsWithAttribute( HIDDEN ) ); }
+#ifdef GAME_SELF_CHECK
+  bool      checkInvariants();
+#endif
+#ifdef MEMORY_MONITOR_ENABLED
+  bool      isLevelIntact() { return( ( levelGuardFront == LEVEL_GUARD ) && ( levelGuardBack == LEVEL_GUARD ) ); }
+#endif
 
 
 private:
+  void      initialize();
   uint8_t   countNeighbors( const int8_t x, const int8_t y );
+  uint8_t   uncoverFirstCell( const int8_t x, const int8_t y );
+  bool      uncoverStep( uint8_t budget );
+  uint8_t   uncoverAround( const int8_t x, const int8_t y );
+#ifdef GAME_BITBOARDS
+  void      uncoverRegion();
+#endif
   void      clearLevel();
   uint8_t   countCellsWithAttribute( uint8_t mask );
+#ifdef GAME_SELF_CHECK
+  bool      selfCheckFailed( const __FlashStringHelper *reason, const uint8_t position );
+#endif
 
 // Attributes
 private:
@@ -76,14 +166,33 @@ private:
   uint8_t   flagsCount;
   // number of clicks
   uint16_t  clicksCount;
-  // level size
-  uint8_t   levelWidth;
-  uint8_t   levelHeight;
   // cursor position
   uint8_t   cursorX;
   uint8_t   cursorY;
+  // scan position and state of the flood fill
+  uint8_t   fillX;
+  uint8_t   fillY;
+  bool      fillChanged;
+#ifdef PROGRESSIVE_REVEAL
+  bool      uncovering;
+#endif
   // seed value
   long      seed;
-  // level data
+  // level data (surrounded by sentinels, if the memory monitor is enabled)
+#ifdef MEMORY_MONITOR_ENABLED
+  uint16_t  levelGuardFront;
+#endif
   uint8_t   levelData[MAX_GAME_COLS * MAX_GAME_ROWS];
+#ifdef MEMORY_MONITOR_ENABLED
+  uint16_t  levelGuardBack;
+#endif
 };
+
+// the level size of 'Game' (see LevelSize below)
+#ifdef GAME_VARIABLE_SIZE
+  typedef BasicGame<0, 0> Game;
+#else
+  typedef BasicGame<MAX_GAME_COLS, MAX_GAME_ROWS> Game;
+#endif
+// for the host tools (any level size up to MAX_GAME_COLS x MAX_GAME_ROWS)
+typedef BasicGame<0, 0> VariableSizeGame;
@@ -0,0 +1,85 @@
+#include <Arduino.h>
+#include "bitBoard.h"
+
+/*--------------------------------------------------------------*/
+// the bits of the cells 0..width-1 (up to 16)
+static BitRow widthMask( const uint8_t width )
+{
+  return( BitRow( 0xffff ) >> ( 16 - width ) );
+}
+
+/*--------------------------------------------------------------*/
+// Sets the bits of all cells with ( cell & mask ) == value.
+void bitBoardFromLevel( BitRow *rows, const uint8_t *level, const uint8_t width, const uint8_t height,
+                        const uint8_t mask, const uint8_t value )
+{
+  for ( uint8_t y = 0; y < height; y++ )
+  {
+    BitRow row = 0;
+    BitRow bit = 1;
+    for ( uint8_t x = 0; x < width; x++ )
+    {
+      if ( ( *level++ & mask ) == value ) { row |= bit; }
+      bit <<= 1;
+    }
+    rows[y] = row;
+  }
+}
+
+/*--------------------------------------------------------------*/
+// Grows the set cells by one cell in all eight directions (in place).
+void bitBoardDilate( BitRow *rows, const uint8_t width, const uint8_t height )
+{
+  BitRow mask = widthMask( width );
+
+  // horizontal
+  for ( uint8_t y = 0; y < height; y++ )
+  {
+    BitRow row = rows[y];
+    rows[y] = ( row | ( row << 1 ) | ( row >> 1 ) ) & mask;
+  }
+
+  // vertical (the row above is already overwritten, so it is kept)
+  BitRow above = 0;
+  for ( uint8_t y = 0; y < height; y++ )
+  {
+    BitRow row = rows[y];
+    BitRow below = ( y + 1 < height ) ? rows[y + 1] : 0;
+    rows[y] = above | row | below;
+    above = row;
+  }
+}
+
+/*--------------------------------------------------------------*/
+// Counts the set neighbors of every cell of row y with bit sliced adders:
+// countBits[0..3] receive bit 0..3 of the counts (0..8).
+void bitBoardCountNeighbors( BitRow *countBits, const BitRow *rows, const uint8_t y, const uint8_t width, const uint8_t height )
+{
+  BitRow mask = widthMask( width );
+  BitRow above = ( y > 0 ) ? rows[y - 1] : 0;
+  BitRow row = rows[y];
+  BitRow below = ( y + 1 < height ) ? rows[y + 1] : 0;
+
+  // the eight neighbors of every cell (the cell itself isn't counted)
+  BitRow inputs[8] = { BitRow( above << 1 ), above, BitRow( above >> 1 ),
+                       BitRow( row << 1 ),          BitRow( row >> 1 ),
+                       BitRow( below << 1 ), below, BitRow( below >> 1 ) };
+
+  BitRow bit0 = 0, bit1 = 0, bit2 = 0, bit3 = 0;
+  for ( uint8_t n = 0; n < 8; n++ )
+  {
+    // add one bit to every counter
+    BitRow carry0 = bit0 & inputs[n];
+    bit0 ^= inputs[n];
+    BitRow carry1 = bit1 & carry0;
+    bit1 ^= carry0;
+    BitRow carry2 = bit2 & carry1;
+    bit2 ^= carry1;
+    bit3 |= carry2;
+  }
+
+  countBits[0] = bit0 & mask;
+  countBits[1] = bit1 & mask;
+  countBits[2] = bit2 & mask;
+  countBits[3] = bit3 & mask;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Bitboard kernels for the level (see GAME_BITBOARDS in TinyMinezGame.h).
+// A board is one 16 bit mask per row, bit x of row y is the cell x,y.
+// The operations work on whole rows, so the board needs a few dozen word
+// operations instead of nine cell accesses per cell.
+
+typedef uint16_t BitRow;
+
+void    bitBoardFromLevel( BitRow *rows, const uint8_t *level, const uint8_t width, const uint8_t height,
+                           const uint8_t mask, const uint8_t value );
+void    bitBoardDilate( BitRow *rows, const uint8_t width, const uint8_t height );
+void    bitBoardCountNeighbors( BitRow *countBits, const BitRow *rows, const uint8_t y, const uint8_t width, const uint8_t height );
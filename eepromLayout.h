@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Arduino.h>
+
+// EEPROM usage (the ATtiny85 has only 512 bytes, so keep an eye on the total)
+//
+//  0x000 - 0x07f : replay of the last game (seed + input events)
+//  0x080 - 0x1c9 : game state ring (3 slots, see GameStorage.h)
+//  0x1ff         : I2C bus speed found by TinyI2CMaster::selectSpeed() (TINY_I2C_SPEED_EEPROM, 0xff = probe again)
+//
+const uint16_t EEPROM_REPLAY_START  = 0x000;
+const uint16_t EEPROM_REPLAY_SIZE   = 128;
+
+const uint16_t EEPROM_STORAGE_START = 0x080;
+const uint8_t  EEPROM_STORAGE_SLOTS = 3;
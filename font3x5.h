@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Arduino.h>
+
+// A tiny 3x5 pixel font for 'displayZoomedText()' (upper case only).
+// Every glyph consists of 3 columns (LSB is the top row), the 5 pixel rows are
+// stored in bits 1..5, so the zoomed glyph gets a 2 pixel margin above.
+// The characters range from ' ' to 'Z'.
+const uint8_t FONT_3X5_FIRST_CHAR = ' ';
+const uint8_t FONT_3X5_LAST_CHAR = 'Z';
+const uint8_t FONT_3X5_WIDTH = 3;
+
+const uint8_t font3x5[] PROGMEM = {
+  0x00, 0x00, 0x00, // ' '
+  0x00, 0x2e, 0x00, // '!'
+  0x06, 0x00, 0x06, // '"'
+  0x3e, 0x14, 0x3e, // '#'
+  0x24, 0x3e, 0x12, // '$'
+  0x32, 0x08, 0x26, // '%'
+  0x14, 0x2a, 0x34, // '&'
+  0x00, 0x06, 0x00, // '\''
+  0x00, 0x1c, 0x22, // '('
+  0x22, 0x1c, 0x00, // ')'
+  0x14, 0x08, 0x14, // '*'
+  0x08, 0x1c, 0x08, // '+'
+  0x20, 0x10, 0x00, // ','
+  0x08, 0x08, 0x08, // '-'
+  0x00, 0x20, 0x00, // '.'
+  0x30, 0x08, 0x06, // '/'
+  0x3e, 0x22, 0x3e, // '0'
+  0x24, 0x3e, 0x20, // '1'
+  0x3a, 0x2a, 0x2e, // '2'
+  0x22, 0x2a, 0x3e, // '3'
+  0x0e, 0x08, 0x3e, // '4'
+  0x2e, 0x2a, 0x3a, // '5'
+  0x3e, 0x2a, 0x3a, // '6'
+  0x02, 0x32, 0x0e, // '7'
+  0x3e, 0x2a, 0x3e, // '8'
+  0x2e, 0x2a, 0x3e, // '9'
+  0x00, 0x14, 0x00, // ':'
+  0x20, 0x14, 0x00, // ';'
+  0x08, 0x14, 0x22, // '<'
+  0x14, 0x14, 0x14, // '='
+  0x22, 0x14, 0x08, // '>'
+  0x02, 0x2a, 0x0e, // '?'
+  0x1c, 0x2a, 0x2c, // '@'
+  0x3c, 0x0a, 0x3c, // 'A'
+  0x3e, 0x2a, 0x14, // 'B'
+  0x1c, 0x22, 0x22, // 'C'
+  0x3e, 0x22, 0x1c, // 'D'
+  0x3e, 0x2a, 0x22, // 'E'
+  0x3e, 0x0a, 0x02, // 'F'
+  0x1c, 0x22, 0x3a, // 'G'
+  0x3e, 0x08, 0x3e, // 'H'
+  0x22, 0x3e, 0x22, // 'I'
+  0x10, 0x20, 0x1e, // 'J'
+  0x3e, 0x08, 0x36, // 'K'
+  0x3e, 0x20, 0x20, // 'L'
+  0x3e, 0x0c, 0x3e, // 'M'
+  0x3e, 0x02, 0x3c, // 'N'
+  0x1c, 0x22, 0x1c, // 'O'
+  0x3e, 0x0a, 0x04, // 'P'
+  0x1c, 0x32, 0x2c, // 'Q'
+  0x3e, 0x0a, 0x34, // 'R'
+  0x24, 0x2a, 0x12, // 'S'
+  0x02, 0x3e, 0x02, // 'T'
+  0x3e, 0x20, 0x3e, // 'U'
+  0x1e, 0x20, 0x1e, // 'V'
+  0x3e, 0x18, 0x3e, // 'W'
+  0x36, 0x08, 0x36, // 'X'
+  0x06, 0x38, 0x06, // 'Y'
+  0x32, 0x2a, 0x26, // 'Z'
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+// Minimal Arduino environment for compiling the game logic on the host.
+// Only what the sketch actually uses is provided here.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <avr/pgmspace.h>
+
+#define HEX 16
+#define DEC 10
+
+// flash strings are plain strings here, the type is kept for the overloads
+class __FlashStringHelper;
+#define F( string ) ( reinterpret_cast<const __FlashStringHelper *>( string ) )
+
+#ifndef constrain
+  #define constrain( value, low, high ) ( ( value ) < ( low ) ? ( low ) : ( ( value ) > ( high ) ? ( high ) : ( value ) ) )
+#endif
+
+// Serial output goes to 'hostSerialOutput' (discarded if nullptr)
+extern FILE *hostSerialOutput;
+
+class HostSerial
+{
+public:
+  void   begin( long ) {}
+  size_t write( uint8_t value );
+  void   print( const char *text );
+  void   print( const __FlashStringHelper *text ) { print( reinterpret_cast<const char *>( text ) ); }
+  void   print( long value, int base = DEC );
+  void   println( const char *text = "" );
+  void   println( const __FlashStringHelper *text ) { println( reinterpret_cast<const char *>( text ) ); }
+  void   println( long value, int base = DEC );
+};
+
+extern HostSerial Serial;
+
+// Arduino's 'random()' on top of the avr-libc generator (bit exact)
+void randomSeed( unsigned long seed );
+long random( long howBig );
+long random( long howSmall, long howBig );
+
+void delay( unsigned long ms );
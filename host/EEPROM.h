@@ -0,0 +1,16 @@
+#pragma once
+
+// Arduino's EEPROM library on top of the host EEPROM emulation
+
+#include <avr/eeprom.h>
+
+class HostEEPROMClass
+{
+public:
+  uint8_t read( int address ) { return( eeprom_read_byte( (const uint8_t *)uintptr_t( address ) ) ); }
+  void    write( int address, uint8_t value ) { eeprom_write_byte( (uint8_t *)uintptr_t( address ), value ); }
+  void    update( int address, uint8_t value ) { eeprom_update_byte( (uint8_t *)uintptr_t( address ), value ); }
+  uint16_t length() { return( HOST_EEPROM_SIZE ); }
+};
+
+static HostEEPROMClass EEPROM;
@@ -0,0 +1,18 @@
+#pragma once
+
+// EEPROM emulation: a plain array, which can be loaded from/saved to a dump
+// (e.g. 'avrdude -U eeprom:r:dump.bin:r').
+
+#include <stdint.h>
+
+const uint16_t HOST_EEPROM_SIZE = 512;
+extern uint8_t hostEEPROM[HOST_EEPROM_SIZE];
+
+inline uint8_t eeprom_read_byte( const uint8_t *address ) { return( hostEEPROM[uintptr_t( address ) % HOST_EEPROM_SIZE] ); }
+inline void eeprom_write_byte( uint8_t *address, uint8_t value ) { hostEEPROM[uintptr_t( address ) % HOST_EEPROM_SIZE] = value; }
+inline void eeprom_update_byte( uint8_t *address, uint8_t value ) { eeprom_write_byte( address, value ); }
+// the emulated EEPROM is never busy
+inline bool eeprom_is_ready() { return( true ); }
+
+bool hostLoadEEPROM( const char *fileName );
+bool hostSaveEEPROM( const char *fileName );
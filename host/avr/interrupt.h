@@ -0,0 +1,6 @@
+#pragma once
+
+// There are no interrupts on the host, code using ISR() has to provide a fallback.
+
+inline void cli() {}
+inline void sei() {}
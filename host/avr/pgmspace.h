@@ -0,0 +1,12 @@
+#pragma once
+
+// On the host PROGMEM is ordinary memory.
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define pgm_read_byte( address ) ( *(const uint8_t *)( address ) )
+#define pgm_read_word( address ) ( *(const uint16_t *)( address ) )
+#define pgm_read_dword( address ) ( *(const uint32_t *)( address ) )
+#define memcpy_P memcpy
@@ -0,0 +1,179 @@
+// Micro benchmarks for the hot paths of Game on the host.
+//
+// Usage: gameBenchmark [--json] [--min-time ms]
+//
+// Every benchmark is run for all level sizes up to MAX_GAME_COLS x MAX_GAME_ROWS
+// (compile with -DHOST_MAX_GAME_COLS=16 -DHOST_MAX_GAME_ROWS=15 for levels beyond 12x8)
+// and for the four difficulties, scaled to the level size. The level with the
+// maximum size is measured twice: with the size as a runtime value (VariableSizeGame)
+// and as a compile time constant (the 'Game' of the device).
+// The output is CSV (default) or JSON lines, one result per line:
+//
+//   benchmark, width, height, mines, ns/op, iterations, cells, bytes, size
+//
+// 'cells' is the number of cells the operation visits at least once,
+// 'bytes' is the working set (sizeof( Game ) for operations on the level),
+// 'size' is 'runtime' or 'fixed'.
+
+#include <Arduino.h>
+#include <chrono>
+#include "../TinyMinezGame.h"
+
+// the difficulties of the 12x8 level (see TinyMinez.ino)
+static const uint8_t mineDifficulty[] = { 5, 10, 15, 20 };
+
+static bool jsonOutput = false;
+static double minimumTime = 0.02;
+
+// keeps the optimizer from removing the benchmarked code
+static volatile uint32_t sink;
+
+typedef BasicGame<MAX_GAME_COLS, MAX_GAME_ROWS> FixedSizeGame;
+
+static const char *sizeName( const VariableSizeGame & ) { return( "runtime" ); }
+static const char *sizeName( const FixedSizeGame & ) { return( "fixed" ); }
+
+/*--------------------------------------------------------*/
+template <typename LevelGame> static void report( const char *name, const LevelGame &game, double nanoseconds, long iterations, uint16_t cells, size_t bytes )
+{
+  LevelGame level = game;
+  const char *format = jsonOutput
+    ? "{\"benchmark\":\"%s\",\"width\":%u,\"height\":%u,\"mines\":%u,\"ns_per_op\":%.1f,\"iterations\":%ld,\"cells\":%u,\"bytes\":%zu,\"size\":\"%s\"}\n"
+    : "%s,%u,%u,%u,%.1f,%ld,%u,%zu,%s\n";
+  printf( format, name, level.getLevelWidth(), level.getLevelHeight(), level.getMinesCount(),
+          nanoseconds / iterations, iterations, cells, bytes, sizeName( game ) );
+}
+
+/*--------------------------------------------------------*/
+// Runs 'operation' until 'minimumTime' has passed, returns the time in ns
+template <typename Operation> static double measure( Operation operation, long &iterations )
+{
+  using clock = std::chrono::steady_clock;
+
+  iterations = 0;
+  long batch = 1;
+  auto start = clock::now();
+  double elapsed;
+  do
+  {
+    for ( long n = 0; n < batch; n++ ) { operation( iterations + n ); }
+    iterations += batch;
+    batch *= 2;
+    elapsed = std::chrono::duration<double>( clock::now() - start ).count();
+  } while ( elapsed < minimumTime );
+
+  return( elapsed * 1e9 );
+}
+
+/*--------------------------------------------------------*/
+// Returns the position of an empty cell (the largest flood fill) or the first safe cell
+template <typename LevelGame> static uint8_t findStartCell( LevelGame &game )
+{
+  uint8_t safeCell = 0xff;
+  for ( uint8_t y = 0; y < game.getLevelHeight(); y++ )
+  {
+    for ( uint8_t x = 0; x < game.getLevelWidth(); x++ )
+    {
+      uint8_t value = game.getCellValue( x, y ) & ( BOMB | COUNT_MASK );
+      if ( value == EMPTY ) { return( x + y * game.getLevelWidth() ); }
+      if ( !( value & BOMB ) && ( safeCell == 0xff ) ) { safeCell = x + y * game.getLevelWidth(); }
+    }
+  }
+  return( safeCell );
+}
+
+/*--------------------------------------------------------*/
+// 'emptyLevel' defines the level size (and the type of the game)
+template <typename LevelGame> static void benchmarkLevel( const LevelGame &emptyLevel, uint8_t mines )
+{
+  LevelGame game = emptyLevel;
+  uint8_t width = game.getLevelWidth();
+  uint8_t height = game.getLevelHeight();
+  uint16_t cells = width * height;
+  long iterations;
+  double time;
+
+  game.setSeed( 1 );
+  game.createLevel( mines );
+  game.setStatus( Status::playGame );
+
+  // new seed for every level, like on the device
+  time = measure( [&]( long n ) { LevelGame level = emptyLevel; level.setSeed( n + 1 ); level.createLevel( mines ); sink += level.getCellValue( 0, 0 ); }, iterations );
+  report( "createLevel", game, time, iterations, cells, sizeof( LevelGame ) );
+
+  // copying the level is part of every uncover iteration, so it's measured separately
+  time = measure( [&]( long ) { LevelGame level = game; sink += level.getCellValue( 0, 0 ); }, iterations );
+  report( "copyGame", game, time, iterations, cells, sizeof( LevelGame ) );
+
+  uint8_t start = findStartCell( game );
+  uint8_t startX = start % width;
+  uint8_t startY = start / width;
+  LevelGame uncovered = game;
+  uncovered.uncoverCells( startX, startY );
+  uint16_t uncoveredCells = cells - uncovered.getHiddenTilesCount();
+
+  time = measure( [&]( long ) { LevelGame level = game; sink += level.uncoverCells( startX, startY ); }, iterations );
+  report( "uncoverCells+copy", game, time, iterations, uncoveredCells, sizeof( LevelGame ) );
+
+  time = measure( [&]( long ) { sink += game.getHiddenTilesCount(); }, iterations );
+  report( "countCellsWithAttribute", game, time, iterations, cells, cells );
+
+  time = measure( [&]( long ) { sink += game.isWon(); }, iterations );
+  report( "isWon", game, time, iterations, cells, cells );
+
+  time = measure( [&]( long n ) { game.setCursorPosition( n % width, ( n / width ) % height ); }, iterations );
+  report( "setCursorPosition", game, time, iterations, cells, cells );
+
+  time = measure( [&]( long n ) { game.toggleFlag( n % width, ( n / width ) % height ); }, iterations );
+  report( "toggleFlag", game, time, iterations, 1, 1 );
+}
+
+/*--------------------------------------------------------*/
+// steps of 4 up to 'maximum', 0 if done
+static uint8_t nextSize( uint8_t size, uint8_t maximum )
+{
+  if ( size >= maximum ) { return( 0 ); }
+  return( ( size + 4 < maximum ) ? size + 4 : maximum );
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  for ( int n = 1; n < argc; n++ )
+  {
+    if ( strcmp( argv[n], "--json" ) == 0 ) { jsonOutput = true; }
+    else if ( ( strcmp( argv[n], "--min-time" ) == 0 ) && ( n + 1 < argc ) ) { minimumTime = atof( argv[++n] ) / 1000.0; }
+    else
+    {
+      fprintf( stderr, "usage: %s [--json] [--min-time ms]\n", argv[0] );
+      return( 2 );
+    }
+  }
+
+  if ( !jsonOutput ) { printf( "benchmark,width,height,mines,ns_per_op,iterations,cells,bytes,size\n" ); }
+
+  // from tiny to the largest level in steps of 4 columns and rows
+  for ( uint8_t height = 4; height != 0; height = nextSize( height, MAX_GAME_ROWS ) )
+  {
+    for ( uint8_t width = 4; width != 0; width = nextSize( width, MAX_GAME_COLS ) )
+    {
+      for ( uint8_t difficulty : mineDifficulty )
+      {
+        // same mine density as on the 12x8 level
+        uint8_t mines = ( difficulty * width * height + 48 ) / 96;
+        if ( mines < 1 ) { mines = 1; }
+        benchmarkLevel( VariableSizeGame( width, height ), mines );
+      }
+    }
+  }
+
+  // the level of the device, the size is a compile time constant
+  for ( uint8_t difficulty : mineDifficulty )
+  {
+    uint8_t mines = ( difficulty * MAX_GAME_COLS * MAX_GAME_ROWS + 48 ) / 96;
+    if ( mines < 1 ) { mines = 1; }
+    benchmarkLevel( FixedSizeGame(), mines );
+  }
+
+  return( 0 );
+}
@@ -0,0 +1,109 @@
+// Host implementation of the Arduino functions declared in host/Arduino.h
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+
+FILE *hostSerialOutput = nullptr;
+HostSerial Serial;
+uint8_t hostEEPROM[HOST_EEPROM_SIZE];
+
+/*--------------------------------------------------------------*/
+size_t HostSerial::write( uint8_t value )
+{
+  if ( hostSerialOutput != nullptr ) { fputc( value, hostSerialOutput ); }
+  return( 1 );
+}
+
+/*--------------------------------------------------------------*/
+void HostSerial::print( const char *text )
+{
+  if ( hostSerialOutput != nullptr ) { fputs( text, hostSerialOutput ); }
+}
+
+/*--------------------------------------------------------------*/
+void HostSerial::print( long value, int base )
+{
+  if ( hostSerialOutput != nullptr ) { fprintf( hostSerialOutput, ( base == HEX ) ? "%lX" : "%ld", value ); }
+}
+
+/*--------------------------------------------------------------*/
+void HostSerial::println( const char *text )
+{
+  print( text );
+  print( "\r\n" );
+}
+
+/*--------------------------------------------------------------*/
+void HostSerial::println( long value, int base )
+{
+  print( value, base );
+  print( "\r\n" );
+}
+
+/*--------------------------------------------------------------*/
+// avr-libc's 'random()' (Park-Miller "minimal standard" generator)
+static uint32_t randomContext = 1;
+
+static int32_t doRandom()
+{
+  int32_t x = randomContext;
+  // can't be initialized with 0, so use another value
+  if ( x == 0 ) { x = 123459876L; }
+  int32_t hi = x / 127773L;
+  int32_t lo = x % 127773L;
+  x = 16807L * lo - 2836L * hi;
+  if ( x < 0 ) { x += 0x7fffffffL; }
+  randomContext = x;
+  return( x % 0x80000000UL );
+}
+
+/*--------------------------------------------------------------*/
+void randomSeed( unsigned long seed )
+{
+  // like Arduino: a seed of 0 is ignored
+  if ( seed != 0 ) { randomContext = uint32_t( seed ); }
+}
+
+/*--------------------------------------------------------------*/
+long random( long howBig )
+{
+  if ( howBig == 0 ) { return( 0 ); }
+  return( doRandom() % howBig );
+}
+
+/*--------------------------------------------------------------*/
+long random( long howSmall, long howBig )
+{
+  if ( howSmall >= howBig ) { return( howSmall ); }
+  return( random( howBig - howSmall ) + howSmall );
+}
+
+/*--------------------------------------------------------------*/
+// there is no real waiting, only the virtual clock advances
+uint32_t hostVirtualMicros = 0;
+
+void delay( unsigned long ms )
+{
+  hostVirtualMicros += ms * 1000;
+}
+
+/*--------------------------------------------------------------*/
+bool hostLoadEEPROM( const char *fileName )
+{
+  FILE *file = fopen( fileName, "rb" );
+  if ( file == nullptr ) { return( false ); }
+  memset( hostEEPROM, 0xff, sizeof( hostEEPROM ) );
+  fread( hostEEPROM, 1, sizeof( hostEEPROM ), file );
+  fclose( file );
+  return( true );
+}
+
+/*--------------------------------------------------------------*/
+bool hostSaveEEPROM( const char *fileName )
+{
+  FILE *file = fopen( fileName, "wb" );
+  if ( file == nullptr ) { return( false ); }
+  bool success = ( fwrite( hostEEPROM, 1, sizeof( hostEEPROM ), file ) == sizeof( hostEEPROM ) );
+  fclose( file );
+  return( success );
+}
@@ -0,0 +1,33 @@
+// Host implementation of tinyJoypadUtils: no buttons, no sound, no display.
+
+#include <Arduino.h>
+#include "../tinyJoypadUtils.h"
+
+void InitTinyJoypad() {}
+
+bool isLeftPressed() { return( false ); }
+bool isRightPressed() { return( false ); }
+bool isUpPressed() { return( false ); }
+bool isDownPressed() { return( false ); }
+bool isFirePressed() { return( false ); }
+bool isFlagPressed() { return( false ); }
+
+void InitFrameTimer() {}
+void waitForNextFrame() {}
+void waitFrames( uint8_t ) {}
+
+void waitUntilButtonsReleased() {}
+void waitUntilButtonsReleased( const uint8_t ) {}
+void _variableDelay_us( uint8_t ) {}
+// deterministic on the host, use Game::setSeed() for other levels
+uint16_t getHardwareEntropy() { return( 1 ); }
+uint8_t getTimerJitter() { return( 0 ); }
+void Sound( const uint8_t, const uint8_t ) {}
+
+void InitDisplay() {}
+void TinyFlip_PrepareDisplayRow( uint8_t ) {}
+void TinyFlip_SendPixels( uint8_t ) {}
+void TinyFlip_FinishDisplayRow() {}
+bool TinyFlip_PageChanged( uint8_t ) { return( false ); }
+void TinyFlip_DisplayBuffer() {}
+void TinyFlip_SerialScreenshot() {}
@@ -0,0 +1,187 @@
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include "levelSolver.h"
+
+/*--------------------------------------------------------*/
+GameResult Solver::play( bool allowGuesses )
+{
+  // the first click is a guess, too (there is no safe first click)
+  click( width / 2 + ( height / 2 ) * width );
+
+  while ( game.getStatus() == Status::playGame )
+  {
+    if ( !applyRules() )
+    {
+      if ( !allowGuesses ) { break; }
+      result.guesses++;
+      click( bestGuess() );
+    }
+  }
+
+  result.won = ( game.getStatus() == Status::gameWon );
+  return( result );
+}
+
+/*--------------------------------------------------------*/
+void Solver::click( uint8_t n )
+{
+  uint8_t x = n % width;
+  uint8_t y = n / width;
+
+  game.setCursorPosition( x, y );
+  auto start = std::chrono::steady_clock::now();
+  game.uncoverAndUpdateStatus( x, y );
+  result.uncoverNanoseconds += std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count();
+  result.clicks++;
+}
+
+/*--------------------------------------------------------*/
+void Solver::markMine( uint8_t n )
+{
+  mine[n] = true;
+  game.toggleFlag( n % width, n / width );
+}
+
+/*--------------------------------------------------------*/
+// One constraint per uncovered number with unknown neighbors:
+// 'mines' of the 'count' unknown cells are mines.
+void Solver::collectConstraints()
+{
+  constraints.clear();
+
+  for ( uint8_t n = 0; n < cells; n++ )
+  {
+    if ( isHidden( n ) || ( number( n ) == 0 ) ) { continue; }
+
+    Constraint constraint;
+    constraint.count = 0;
+    constraint.mines = number( n );
+
+    int8_t x = n % width;
+    int8_t y = n / width;
+    for ( int8_t offsetY = -1; offsetY <= 1; offsetY++ )
+    {
+      for ( int8_t offsetX = -1; offsetX <= 1; offsetX++ )
+      {
+        if ( !game.isPositionValid( x + offsetX, y + offsetY ) ) { continue; }
+        uint8_t neighbor = ( x + offsetX ) + ( y + offsetY ) * width;
+        if ( !isHidden( neighbor ) ) { continue; }
+        if ( mine[neighbor] ) { constraint.mines--; }
+        else { constraint.unknown[constraint.count++] = neighbor; }
+      }
+    }
+
+    if ( constraint.count > 0 ) { constraints.push_back( constraint ); }
+  }
+}
+
+/*--------------------------------------------------------*/
+bool Solver::contains( const Constraint &set, uint8_t n )
+{
+  return( std::find( set.unknown, set.unknown + set.count, n ) != set.unknown + set.count );
+}
+
+/*--------------------------------------------------------*/
+// Applies the single cell and subset rules, returns true if anything was found
+bool Solver::applyRules()
+{
+  collectConstraints();
+  safeCells.clear();
+  bool progress = false;
+
+  for ( const Constraint &constraint : constraints )
+  {
+    if ( constraint.mines == 0 )
+    {
+      safeCells.insert( safeCells.end(), constraint.unknown, constraint.unknown + constraint.count );
+    }
+    else if ( constraint.mines == constraint.count )
+    {
+      for ( uint8_t n = 0; n < constraint.count; n++ )
+      {
+        if ( !mine[constraint.unknown[n]] ) { markMine( constraint.unknown[n] ); progress = true; }
+      }
+    }
+  }
+
+  if ( safeCells.empty() && !progress )
+  {
+    // subset rule: if A is a subset of B, B \ A contains B.mines - A.mines mines
+    for ( const Constraint &a : constraints )
+    {
+      for ( const Constraint &b : constraints )
+      {
+        if ( ( &a == &b ) || ( a.count >= b.count ) ) { continue; }
+        bool subset = true;
+        for ( uint8_t n = 0; ( n < a.count ) && subset; n++ ) { subset = contains( b, a.unknown[n] ); }
+        if ( !subset ) { continue; }
+
+        uint8_t difference = b.count - a.count;
+        uint8_t mines = b.mines - a.mines;
+        for ( uint8_t n = 0; n < b.count; n++ )
+        {
+          uint8_t cell = b.unknown[n];
+          if ( contains( a, cell ) ) { continue; }
+          if ( mines == 0 ) { safeCells.push_back( cell ); result.subsetRules++; }
+          else if ( ( mines == difference ) && !mine[cell] ) { markMine( cell ); progress = true; result.subsetRules++; }
+        }
+      }
+    }
+  }
+
+  // uncover the safe cells (the status may change on the way)
+  for ( uint8_t cell : safeCells )
+  {
+    if ( game.getStatus() != Status::playGame ) { break; }
+    if ( isHidden( cell ) ) { click( cell ); progress = true; }
+  }
+
+  return( progress );
+}
+
+/*--------------------------------------------------------*/
+// Estimates the mine probability of every unknown cell: cells next to numbers
+// take the worst ratio of their constraints, all others share the remaining mines.
+uint8_t Solver::bestGuess()
+{
+  double probability[MAX_CELLS];
+  bool   frontier[MAX_CELLS] = { false };
+  uint8_t knownMines = 0;
+  uint8_t unknownCells = 0;
+
+  for ( uint8_t n = 0; n < cells; n++ )
+  {
+    probability[n] = 0.0;
+    if ( mine[n] ) { knownMines++; }
+    else if ( isHidden( n ) ) { unknownCells++; }
+  }
+
+  uint8_t frontierCells = 0;
+  for ( const Constraint &constraint : constraints )
+  {
+    double ratio = double( constraint.mines ) / constraint.count;
+    for ( uint8_t n = 0; n < constraint.count; n++ )
+    {
+      uint8_t cell = constraint.unknown[n];
+      if ( !frontier[cell] ) { frontier[cell] = true; frontierCells++; }
+      probability[cell] = std::max( probability[cell], ratio );
+    }
+  }
+
+  // the mines which aren't found yet are spread over the cells not touching any number
+  uint8_t remainingMines = game.getMinesCount() - knownMines;
+  uint8_t otherCells = unknownCells - frontierCells;
+  double otherProbability = otherCells ? double( remainingMines ) / unknownCells : 1.0;
+
+  uint8_t best = 0xff;
+  double bestProbability = 2.0;
+  for ( uint8_t n = 0; n < cells; n++ )
+  {
+    if ( mine[n] || !isHidden( n ) ) { continue; }
+    double p = frontier[n] ? probability[n] : otherProbability;
+    if ( p < bestProbability ) { bestProbability = p; best = n; }
+  }
+
+  return( best );
+}
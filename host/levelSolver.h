@@ -0,0 +1,65 @@
+#pragma once
+
+// A logical Minesweeper solver which only looks at what the player sees
+// (numbers of uncovered cells). It uses
+// - single cell rules (all mines found / all hidden neighbors are mines),
+// - subset rules between two numbers (the difference of the neighborhoods),
+// - if nothing is certain, the cell with the lowest estimated mine probability.
+// The first click goes to the center of the level (where the cursor starts).
+// Used by solverBot and seedBank.
+
+#include <Arduino.h>
+#include <vector>
+#include "../TinyMinezGame.h"
+
+const uint8_t MAX_CELLS = MAX_GAME_COLS * MAX_GAME_ROWS;
+
+struct GameResult
+{
+  bool     won;
+  uint16_t clicks;
+  uint16_t guesses;
+  // deductions which needed the subset rule (the harder ones)
+  uint16_t subsetRules;
+  double   uncoverNanoseconds;
+};
+
+/*--------------------------------------------------------*/
+// What the player knows about the level
+class Solver
+{
+public:
+  Solver( VariableSizeGame &game ) : game( game ), width( game.getLevelWidth() ), height( game.getLevelHeight() ),
+                         cells( width * height ) { memset( mine, 0, sizeof( mine ) ); }
+
+  // plays until the game is won or lost, without 'allowGuesses' the game
+  // ends (not won) as soon as a guess would be required
+  GameResult play( bool allowGuesses = true );
+
+private:
+  struct Constraint
+  {
+    uint8_t unknown[8];
+    uint8_t count;
+    uint8_t mines;
+  };
+
+  bool    isHidden( uint8_t n ) { return( game.getCellValue( n % width, n / width ) & HIDDEN ); }
+  uint8_t number( uint8_t n ) { return( game.getCellValue( n % width, n / width ) & COUNT_MASK ); }
+  void    collectConstraints();
+  bool    applyRules();
+  uint8_t bestGuess();
+  void    click( uint8_t n );
+  void    markMine( uint8_t n );
+  bool    contains( const Constraint &set, uint8_t n );
+
+  VariableSizeGame &game;
+  uint8_t width;
+  uint8_t height;
+  uint8_t cells;
+  // cells known to be mines
+  bool    mine[MAX_CELLS];
+  std::vector<Constraint> constraints;
+  std::vector<uint8_t>    safeCells;
+  GameResult result = { false, 0, 0, 0, 0.0 };
+};
@@ -0,0 +1,71 @@
+// Replays a game recorded by the device (see Replay.h) at full CPU speed.
+//
+// Usage: replayPlayer <eeprom.bin> [repetitions] [--level]
+//
+//   eeprom.bin  - raw EEPROM dump, e.g. 'avrdude -p t85 -c usbasp -U eeprom:r:eeprom.bin:r'
+//   repetitions - replay the game n times (for profiling), default 1
+//   --level     - write the final level as a binary frame to stdout,
+//                 pipe into 'tools/serial_receiver.py /dev/stdin -r' for a board view
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include <chrono>
+#include "../TinyMinezGame.h"
+#include "../Replay.h"
+
+static const char *statusNames[] = { "intro", "rules", "difficultySelection", "prepareGame",
+                                     "playGame", "boom", "gameOver", "gameWon" };
+
+int main( int argc, char *argv[] )
+{
+  if ( argc < 2 )
+  {
+    fprintf( stderr, "usage: %s <eeprom.bin> [repetitions] [--level]\n", argv[0] );
+    return( 2 );
+  }
+
+  if ( !hostLoadEEPROM( argv[1] ) )
+  {
+    fprintf( stderr, "can't read '%s'\n", argv[1] );
+    return( 2 );
+  }
+
+  long repetitions = 1;
+  bool dumpLevel = false;
+  for ( int n = 2; n < argc; n++ )
+  {
+    if ( strcmp( argv[n], "--level" ) == 0 ) { dumpLevel = true; }
+    else { repetitions = atol( argv[n] ); }
+  }
+
+  Replay replay;
+  if ( !replay.hasRecording() )
+  {
+    fprintf( stderr, "no recording found in '%s'\n", argv[1] );
+    return( 1 );
+  }
+
+  Game game;
+  Status status = Status::intro;
+
+  auto start = std::chrono::steady_clock::now();
+  for ( long n = 0; n < repetitions; n++ )
+  {
+    status = replay.play( game );
+  }
+  auto end = std::chrono::steady_clock::now();
+  double nanoseconds = std::chrono::duration<double, std::nano>( end - start ).count();
+
+  fprintf( stderr, "seed = %ld, mines = %u, status = %s, clicks = %u, hidden = %u, flags = %u\n",
+           replay.getRecordedSeed(), game.getMinesCount(), statusNames[uint8_t( status )],
+           game.getClicksCount(), game.getHiddenTilesCount(), game.getFlaggedTilesCount() );
+  fprintf( stderr, "%ld replays, %.0f ns per replay\n", repetitions, nanoseconds / repetitions );
+
+  if ( dumpLevel )
+  {
+    hostSerialOutput = stdout;
+    game.serialPrintLevel();
+  }
+
+  return( 0 );
+}
@@ -0,0 +1,212 @@
+// Searches seeds of the 12x8 level which can be solved without guessing and
+// writes them as a PROGMEM table for the firmware (see _ENABLE_SEED_BANK_ in TinyMinez.ino).
+//
+// Usage: seedBank [--seeds n] [--count n] [--threads n] [--min-clicks n] [--min-subset n] [--output file]
+//
+//   --seeds n       seeds 1..n are tried for every difficulty (default and maximum 65535)
+//   --count n       seeds per difficulty in the table, a power of 2 (default 16)
+//   --threads n     worker threads (default: all cores)
+//   --min-clicks n  skip levels which are won with fewer clicks (default 3)
+//   --min-subset n  only levels which need at least n subset deductions (default 0)
+//   --output file   the generated header (default: statistics only)
+//
+// The levels are created by the game code itself (Game::createLevel() with tinyRandom),
+// so a seed gives exactly the same level on the device. A level qualifies if the solver
+// from 'levelSolver.h' wins it with deterministic rules only, starting with the first
+// click at the center, where the cursor starts. The table holds the lowest qualifying
+// seeds, so the result doesn't depend on the number of threads. The generator has
+// 16 bits of state, larger seeds would only repeat the levels of 1..65535.
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "levelSolver.h"
+
+// the difficulties of the 12x8 level (see TinyMinez.ino)
+static const uint8_t mineDifficulty[] = { 5, 10, 15, 20 };
+const uint8_t DIFFICULTIES = sizeof( mineDifficulty );
+
+// the level generator uses a global random state
+static std::mutex levelMutex;
+
+struct Candidate
+{
+  long     seed;
+  uint16_t clicks;
+  uint16_t subsetRules;
+};
+
+struct Statistics
+{
+  long noGuess[DIFFICULTIES] = { 0 };
+  std::vector<Candidate> candidates[DIFFICULTIES];
+};
+
+/*--------------------------------------------------------*/
+static void classifyLevels( long firstSeed, long lastSeed, uint16_t minClicks, uint16_t minSubsetRules, Statistics &statistics )
+{
+  for ( long seed = firstSeed; seed <= lastSeed; seed++ )
+  {
+    for ( uint8_t difficulty = 0; difficulty < DIFFICULTIES; difficulty++ )
+    {
+      VariableSizeGame game( 12, 8 );
+      {
+        std::lock_guard<std::mutex> lock( levelMutex );
+        game.setSeed( seed );
+        game.createLevel( mineDifficulty[difficulty] );
+      }
+      game.setStatus( Status::playGame );
+
+      Solver solver( game );
+      GameResult result = solver.play( false );
+      if ( !result.won ) { continue; }
+
+      statistics.noGuess[difficulty]++;
+      if ( ( result.clicks >= minClicks ) && ( result.subsetRules >= minSubsetRules ) )
+      {
+        statistics.candidates[difficulty].push_back( { seed, result.clicks, result.subsetRules } );
+      }
+    }
+  }
+}
+
+/*--------------------------------------------------------*/
+static bool writeHeader( const char *fileName, const std::vector<Candidate> *bank, unsigned count, long seeds, uint16_t minClicks, uint16_t minSubsetRules )
+{
+  FILE *file = fopen( fileName, "w" );
+  if ( file == nullptr ) { return( false ); }
+
+  fprintf( file, "#pragma once\n\n#include <Arduino.h>\n\n" );
+  fprintf( file, "// Generated by host/seedBank.cpp (--seeds %ld --count %u --min-clicks %u --min-subset %u), do not edit.\n",
+                 seeds, count, minClicks, minSubsetRules );
+  fprintf( file, "// Seeds of 12x8 levels which can be solved without guessing, when the first\n" );
+  fprintf( file, "// click goes to the center (where the cursor starts). One row per difficulty.\n\n" );
+  fprintf( file, "const uint8_t SEED_BANK_SIZE = %u;\n\n", count );
+  fprintf( file, "const uint16_t seedBank[][SEED_BANK_SIZE] PROGMEM =\n{\n" );
+
+  for ( uint8_t difficulty = 0; difficulty < DIFFICULTIES; difficulty++ )
+  {
+    fprintf( file, "  // %u mines\n  {\n   ", mineDifficulty[difficulty] );
+    for ( unsigned n = 0; n < count; n++ )
+    {
+      const char *separator = ( n + 1 == count ) ? "\n" : ( ( n % 8 == 7 ) ? ",\n   " : "," );
+      fprintf( file, " %lu%s", (unsigned long)bank[difficulty][n].seed, separator );
+    }
+    fprintf( file, "  },\n" );
+  }
+
+  fprintf( file, "};\n" );
+  fclose( file );
+  return( true );
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  long seeds = 65535;
+  unsigned count = 16;
+  unsigned threads = std::max( 1u, std::thread::hardware_concurrency() );
+  uint16_t minClicks = 3;
+  uint16_t minSubsetRules = 0;
+  const char *outputFile = nullptr;
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    bool hasValue = ( n + 1 < argc );
+    if ( ( strcmp( argv[n], "--seeds" ) == 0 ) && hasValue ) { seeds = atol( argv[++n] ); }
+    else if ( ( strcmp( argv[n], "--count" ) == 0 ) && hasValue ) { count = atoi( argv[++n] ); }
+    else if ( ( strcmp( argv[n], "--threads" ) == 0 ) && hasValue ) { threads = std::max( 1, atoi( argv[++n] ) ); }
+    else if ( ( strcmp( argv[n], "--min-clicks" ) == 0 ) && hasValue ) { minClicks = atoi( argv[++n] ); }
+    else if ( ( strcmp( argv[n], "--min-subset" ) == 0 ) && hasValue ) { minSubsetRules = atoi( argv[++n] ); }
+    else if ( ( strcmp( argv[n], "--output" ) == 0 ) && hasValue ) { outputFile = argv[++n]; }
+    else
+    {
+      fprintf( stderr, "usage: %s [--seeds n] [--count n] [--threads n] [--min-clicks n] [--min-subset n] [--output file]\n", argv[0] );
+      return( 2 );
+    }
+  }
+
+  if ( ( seeds < 1 ) || ( seeds > 65535 ) )
+  {
+    fprintf( stderr, "--seeds must be 1..65535 (16 bit seeds)\n" );
+    return( 2 );
+  }
+
+  // the firmware masks the index
+  if ( ( count == 0 ) || ( count > 256 ) || ( count & ( count - 1 ) ) )
+  {
+    fprintf( stderr, "--count must be a power of 2 (1..256)\n" );
+    return( 2 );
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<Statistics> results( threads );
+  std::vector<std::thread> workers;
+  for ( unsigned t = 0; t < threads; t++ )
+  {
+    long first = 1 + seeds * t / threads;
+    long last = seeds * ( t + 1 ) / threads;
+    workers.emplace_back( classifyLevels, first, last, minClicks, minSubsetRules, std::ref( results[t] ) );
+  }
+  for ( std::thread &worker : workers ) { worker.join(); }
+
+  double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+  printf( "%ld seeds per difficulty, %u threads, %.1f s (%.0f levels/s)\n",
+          seeds, threads, seconds, seeds * DIFFICULTIES / seconds );
+  printf( "mines  no guess  qualified  table clicks avg  table subset rules avg\n" );
+
+  bool complete = true;
+  std::vector<Candidate> bank[DIFFICULTIES];
+  for ( uint8_t difficulty = 0; difficulty < DIFFICULTIES; difficulty++ )
+  {
+    long noGuess = 0;
+    std::vector<Candidate> &candidates = bank[difficulty];
+    for ( const Statistics &result : results )
+    {
+      noGuess += result.noGuess[difficulty];
+      candidates.insert( candidates.end(), result.candidates[difficulty].begin(), result.candidates[difficulty].end() );
+    }
+    std::sort( candidates.begin(), candidates.end(), []( const Candidate &a, const Candidate &b ) { return( a.seed < b.seed ); } );
+
+    long qualified = candidates.size();
+    if ( candidates.size() > count ) { candidates.resize( count ); }
+
+    double clicks = 0.0;
+    double subsetRules = 0.0;
+    for ( const Candidate &candidate : candidates )
+    {
+      clicks += candidate.clicks;
+      subsetRules += candidate.subsetRules;
+    }
+    if ( !candidates.empty() )
+    {
+      clicks /= candidates.size();
+      subsetRules /= candidates.size();
+    }
+
+    printf( "%5u  %7.2f%%  %9ld  %16.1f  %22.1f\n",
+            mineDifficulty[difficulty], 100.0 * noGuess / std::max( 1L, seeds ), qualified, clicks, subsetRules );
+
+    if ( candidates.size() < count )
+    {
+      fprintf( stderr, "only %zu of %u seeds found for %u mines, try more seeds\n", candidates.size(), count, mineDifficulty[difficulty] );
+      complete = false;
+    }
+  }
+
+  if ( outputFile == nullptr ) { return( 0 ); }
+  if ( !complete ) { return( 1 ); }
+
+  if ( !writeHeader( outputFile, bank, count, seeds, minClicks, minSubsetRules ) )
+  {
+    fprintf( stderr, "can't write '%s'\n", outputFile );
+    return( 1 );
+  }
+  printf( "seed bank written to '%s'\n", outputFile );
+
+  return( 0 );
+}
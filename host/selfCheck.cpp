@@ -0,0 +1,312 @@
+// Plays random levels with random actions and verifies the game after every
+// action, the first violation ends the run.
+//
+// Usage: selfCheck [--games n] [--seed n] [--size WxH] [--serial]
+//
+//   --games n   number of levels (default 100000)
+//   --seed n    start value of the random generator (default 1)
+//   --size WxH  fixed level size instead of a random size per level
+//   --serial    send the serial output (reason of a failed Game::checkInvariants()
+//               and binary level frames) to stdout, pipe into 'tools/serial_receiver.py /dev/stdin'
+//
+// Compile with -DGAME_SELF_CHECK (required), -DPROGRESSIVE_REVEAL for the flood
+// fill in slices and -DHOST_MAX_GAME_COLS=... -DHOST_MAX_GAME_ROWS=... for levels
+// beyond 12x8. The level size, the number of mines, the level seed and the actions
+// (cursor moves, flags, uncovering) are random.
+//
+// Besides the structural checks of Game::checkInvariants() the harness has its own
+// model of the game: the neighbor counts are counted again and every uncover is
+// compared against a breadth first search on a copy of the level. Returns 1 on the
+// first violation, the game and the level are printed, the same --seed repeats the run.
+
+#include <Arduino.h>
+#include "../TinyMinezGame.h"
+
+#ifndef GAME_SELF_CHECK
+  #error "compile with -DGAME_SELF_CHECK"
+#endif
+
+static const char *statusNames[] = { "intro", "rules", "difficultySelection", "prepareGame",
+                                     "playGame", "boom", "gameOver", "gameWon" };
+
+/*--------------------------------------------------------*/
+// Prints the level: '#' hidden, 'F' flag, '*' mine, '.' or the count if uncovered,
+// the cursor is in brackets.
+static void printLevel( VariableSizeGame &game )
+{
+  for ( uint8_t y = 0; y < game.getLevelHeight(); y++ )
+  {
+    for ( uint8_t x = 0; x < game.getLevelWidth(); x++ )
+    {
+      uint8_t value = game.getCellValue( x, y );
+      char symbol;
+      if ( value & FLAG ) { symbol = 'F'; }
+      else if ( value & HIDDEN ) { symbol = '#'; }
+      else if ( value & BOMB ) { symbol = '*'; }
+      else if ( value & COUNT_MASK ) { symbol = '0' + ( value & COUNT_MASK ); }
+      else { symbol = '.'; }
+
+      bool cursor = ( x == game.getCursorX() ) && ( y == game.getCursorY() );
+      printf( cursor ? "[%c]" : " %c ", symbol );
+    }
+    printf( "\n" );
+  }
+}
+
+/*--------------------------------------------------------*/
+// Copies the level, so the result doesn't depend on Game's own accessors.
+static void copyLevel( VariableSizeGame &game, uint8_t *level )
+{
+  for ( uint8_t y = 0; y < game.getLevelHeight(); y++ )
+  {
+    for ( uint8_t x = 0; x < game.getLevelWidth(); x++ )
+    {
+      level[x + y * game.getLevelWidth()] = game.getCellValue( x, y );
+    }
+  }
+}
+
+/*--------------------------------------------------------*/
+// Counts the mines around x,y (independent of Game::countNeighbors()).
+static uint8_t countMinesAround( const uint8_t *level, int8_t width, int8_t height, int8_t x, int8_t y )
+{
+  uint8_t mines = 0;
+  for ( int8_t neighborY = y - 1; neighborY <= y + 1; neighborY++ )
+  {
+    for ( int8_t neighborX = x - 1; neighborX <= x + 1; neighborX++ )
+    {
+      if ( ( neighborX < 0 ) || ( neighborY < 0 ) || ( neighborX >= width ) || ( neighborY >= height ) ) { continue; }
+      if ( ( neighborX == x ) && ( neighborY == y ) ) { continue; }
+      if ( level[neighborX + neighborY * width] & BOMB ) { mines++; }
+    }
+  }
+  return( mines );
+}
+
+/*--------------------------------------------------------*/
+// The uncover of x,y as a breadth first search on 'level',
+// returns the status the game must have afterwards.
+static Status predictUncover( const int8_t width, const int8_t height, const int8_t x, const int8_t y, uint8_t *level, Status status )
+{
+  uint8_t queue[MAX_GAME_COLS * MAX_GAME_ROWS];
+  uint8_t head = 0;
+  uint8_t tail = 0;
+
+  uint8_t position = x + y * width;
+  if ( !( level[position] & HIDDEN ) ) { return( status ); }
+
+  level[position] &= ~( HIDDEN | FLAG );
+  if ( level[position] & BOMB ) { return( Status::boom ); }
+  queue[tail++] = position;
+
+  while ( head != tail )
+  {
+    position = queue[head++];
+    // only empty cells uncover their neighbors
+    if ( level[position] & ( BOMB | COUNT_MASK ) ) { continue; }
+
+    int8_t positionX = position % width;
+    int8_t positionY = position / width;
+    for ( int8_t neighborY = positionY - 1; neighborY <= positionY + 1; neighborY++ )
+    {
+      for ( int8_t neighborX = positionX - 1; neighborX <= positionX + 1; neighborX++ )
+      {
+        if ( ( neighborX < 0 ) || ( neighborY < 0 ) || ( neighborX >= width ) || ( neighborY >= height ) ) { continue; }
+        uint8_t neighbor = neighborX + neighborY * width;
+        if ( level[neighbor] & HIDDEN )
+        {
+          level[neighbor] &= ~( HIDDEN | FLAG );
+          queue[tail++] = neighbor;
+        }
+      }
+    }
+  }
+
+  // won if no safe cell is hidden anymore
+  for ( uint8_t n = 0; n < width * height; n++ )
+  {
+    if ( ( level[n] & ( HIDDEN | BOMB ) ) == HIDDEN ) { return( status ); }
+  }
+  return( Status::gameWon );
+}
+
+/*--------------------------------------------------------*/
+// Verifies the level with the harness' own model, returns the reason of a failure.
+static const char *checkLevel( VariableSizeGame &game )
+{
+  int8_t width = game.getLevelWidth();
+  int8_t height = game.getLevelHeight();
+  uint8_t level[MAX_GAME_COLS * MAX_GAME_ROWS];
+  copyLevel( game, level );
+
+  for ( int8_t y = 0; y < height; y++ )
+  {
+    for ( int8_t x = 0; x < width; x++ )
+    {
+      uint8_t value = level[x + y * width];
+
+      if ( !( value & BOMB ) && ( ( value & COUNT_MASK ) != countMinesAround( level, width, height, x, y ) ) ) { return( "wrong count" ); }
+
+      // an uncovered empty cell must not have hidden neighbors
+      if ( ( value & DATA_MASK ) == EMPTY )
+      {
+        for ( int8_t neighborY = y - 1; neighborY <= y + 1; neighborY++ )
+        {
+          for ( int8_t neighborX = x - 1; neighborX <= x + 1; neighborX++ )
+          {
+            if ( ( neighborX < 0 ) || ( neighborY < 0 ) || ( neighborX >= width ) || ( neighborY >= height ) ) { continue; }
+            if ( level[neighborX + neighborY * width] & HIDDEN ) { return( "incomplete fill" ); }
+          }
+        }
+      }
+
+      // the cursor is only drawn where the CURSOR bit is set (the harness always sets the cursor)
+      bool cursor = ( x == game.getCursorX() ) && ( y == game.getCursorY() );
+      if ( bool( value & CURSOR ) != cursor ) { return( "cursor bit" ); }
+    }
+  }
+
+  if ( !game.checkInvariants() ) { return( "Game::checkInvariants()" ); }
+
+  return( nullptr );
+}
+
+/*--------------------------------------------------------*/
+// Uncovers x,y like the sketch does and compares the result with the model.
+static const char *uncover( VariableSizeGame &game, uint8_t x, uint8_t y )
+{
+  int8_t width = game.getLevelWidth();
+  int8_t height = game.getLevelHeight();
+  uint8_t expected[MAX_GAME_COLS * MAX_GAME_ROWS];
+  copyLevel( game, expected );
+  Status expectedStatus = predictUncover( width, height, x, y, expected, game.getStatus() );
+
+#ifdef PROGRESSIVE_REVEAL
+  game.beginUncover( x, y );
+  // the cursor moves on while the fill is running (one slice per frame)
+  while ( game.isUncovering() )
+  {
+    x = random( width );
+    y = random( height );
+    game.setCursorPosition( x, y );
+    game.continueUncover();
+  }
+#else
+  game.uncoverAndUpdateStatus( x, y );
+#endif
+
+  uint8_t level[MAX_GAME_COLS * MAX_GAME_ROWS];
+  copyLevel( game, level );
+  for ( uint8_t n = 0; n < width * height; n++ )
+  {
+    if ( ( level[n] & ( HIDDEN | FLAG ) ) != ( expected[n] & ( HIDDEN | FLAG ) ) ) { return( "uncover result differs from BFS" ); }
+  }
+  if ( game.getStatus() != expectedStatus ) { return( "wrong status after uncover" ); }
+
+  return( nullptr );
+}
+
+/*--------------------------------------------------------*/
+// Plays one level until it is won or lost (or the actions run out).
+static bool playLevel( VariableSizeGame &game, long gameNumber, long &actions )
+{
+  uint8_t width = game.getLevelWidth();
+  uint8_t height = game.getLevelHeight();
+
+  game.setCursorPosition( game.getCursorX(), game.getCursorY() );
+  game.setStatus( Status::playGame );
+
+  const char *what = "create";
+  const char *failure = checkLevel( game );
+  long action = 0;
+
+  while ( ( failure == nullptr ) && ( ++action <= 4L * width * height ) && ( game.getStatus() == Status::playGame ) )
+  {
+    uint8_t x = random( width );
+    uint8_t y = random( height );
+    long choice = random( 8 );
+
+    game.setCursorPosition( x, y );
+    if ( choice < 4 )
+    {
+      what = "move";
+    }
+    else if ( choice < 5 )
+    {
+      what = "flag";
+      game.toggleFlag( x, y );
+    }
+    else
+    {
+      what = "uncover";
+      // the device ignores uncovering a flagged cell
+      if ( !game.hasFlag( x, y ) ) { failure = uncover( game, x, y ); }
+    }
+
+    actions++;
+    if ( failure == nullptr ) { failure = checkLevel( game ); }
+  }
+
+  if ( failure == nullptr ) { return( true ); }
+
+  printf( "game %ld (%ux%u, %u mines, seed %ld), action %ld (%s), status %s: %s\n",
+          gameNumber, width, height, game.getMinesCount(), game.getSeed(),
+          action, what, statusNames[int( game.getStatus() )], failure );
+  printLevel( game );
+  return( false );
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  long games = 100000;
+  long seed = 1;
+  unsigned width = 0;
+  unsigned height = 0;
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    bool hasValue = ( n + 1 < argc );
+    if ( ( strcmp( argv[n], "--games" ) == 0 ) && hasValue ) { games = atol( argv[++n] ); }
+    else if ( ( strcmp( argv[n], "--seed" ) == 0 ) && hasValue ) { seed = atol( argv[++n] ); }
+    else if ( ( strcmp( argv[n], "--size" ) == 0 ) && hasValue && ( sscanf( argv[++n], "%ux%u", &width, &height ) == 2 ) ) {}
+    else if ( strcmp( argv[n], "--serial" ) == 0 ) { hostSerialOutput = stdout; }
+    else
+    {
+      fprintf( stderr, "usage: %s [--games n] [--seed n] [--size WxH] [--serial]\n", argv[0] );
+      return( 2 );
+    }
+  }
+
+  if ( ( width != 0 ) && ( ( width < 2 ) || ( height < 2 ) || ( width > MAX_GAME_COLS ) || ( height > MAX_GAME_ROWS ) ) )
+  {
+    fprintf( stderr, "level size must be between 2x2 and %ux%u\n", MAX_GAME_COLS, MAX_GAME_ROWS );
+    return( 2 );
+  }
+
+  randomSeed( seed );
+
+  long actions = 0;
+  long results[8] = { 0 };
+  for ( long gameNumber = 1; gameNumber <= games; gameNumber++ )
+  {
+    uint8_t levelWidth = ( width != 0 ) ? width : random( 2, MAX_GAME_COLS + 1 );
+    uint8_t levelHeight = ( height != 0 ) ? height : random( 2, MAX_GAME_ROWS + 1 );
+
+    VariableSizeGame game( levelWidth, levelHeight );
+    game.setSeed( random( 0x7fffffffL ) );
+    // at least one safe cell
+    game.createLevel( random( 1, levelWidth * levelHeight ) );
+
+    if ( !playLevel( game, gameNumber, actions ) )
+    {
+      printf( "self check failed (--seed %ld, game %ld)\n", seed, gameNumber );
+      return( 1 );
+    }
+    results[int( game.getStatus() )]++;
+  }
+
+  printf( "%ld games, %ld actions, no violations (won %ld, lost %ld, unfinished %ld)\n",
+          games, actions, results[int( Status::gameWon )], results[int( Status::boom )], results[int( Status::playGame )] );
+  return( 0 );
+}
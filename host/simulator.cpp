@@ -0,0 +1,428 @@
+// Runs the complete sketch (TinyMinez.ino) on the host.
+//
+// The hardware layer (tinyJoypadUtils) is simulated: the display is a 128x64
+// frame buffer, the buttons come from a script, stdin or a random "monkey",
+// sound is discarded and the time is a virtual clock which is advanced by the
+// frame timer, the sound and all delays. Nothing ever waits, so thousands of
+// games per second are possible.
+//
+// Usage: simulator [options]
+//
+//   --script <file>   button script, '-' reads from stdin (e.g. from another program)
+//   --random          press random buttons (default if there is no script)
+//   --games <n>       stop after n finished games (default 1000 in random mode)
+//   --seed <n>        seed for the levels and the random buttons (default 1)
+//   --frames <dir>    write every displayed frame as <dir>/frame_NNNNNN.pbm
+//   --serial          send the serial output (binary level frames) to stdout
+//   --i2c <file>      write the display traffic of the ATtiny (ssd1306xled) in the capture
+//                     format of 'tools/ssd1306_decoder.py', every displayed frame ends with 'FRAME'
+//   --no-page-hashes  send every page (like the Adafruit builds), by default unchanged
+//                     pages are skipped like on the ATtiny (see _ENABLE_PAGE_HASHES_)
+//
+// Script format: one step per line, '<frames> <buttons>' holds the buttons for
+// the given number of frames. Buttons are 'L', 'R', 'U', 'D', 'F' (fire) and 'B'
+// (flag button), '-' releases all buttons. '#' starts a comment.
+//
+//   200 -      # watch the intro
+//   2 F        # select the difficulty
+//   ...
+//
+// The simulator stops at the end of the script or after the given number of games
+// and prints the statistics to stderr.
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+#include <chrono>
+#include "../tinyRandom.h"
+
+// prototypes (the Arduino IDE generates these automatically)
+void Tiny_Flip( bool invert );
+void reportStatistics();
+void stirSeed();
+void prepareLevel();
+uint8_t* displayBitmapRow( const uint8_t y, const uint8_t *bitmap, const bool invert );
+uint8_t getSpriteData( uint8_t cellValue, uint8_t spriteColumn );
+void waitForFireButtonPressedAndReleased();
+void waitForFireButtonReleased();
+
+#include "../TinyMinez.ino"
+
+enum
+{
+  BUTTON_LEFT  = 0x01,
+  BUTTON_RIGHT = 0x02,
+  BUTTON_UP    = 0x04,
+  BUTTON_DOWN  = 0x08,
+  BUTTON_FIRE  = 0x10,
+  BUTTON_FLAG  = 0x20,
+};
+
+// simulated hardware
+static uint8_t frameBuffer[128 * 8];
+static uint8_t displayRow = 0;
+static uint8_t displayColumn = 0;
+static uint8_t buttons = 0;
+static uint32_t nextFrameMicros = 0;
+
+// page hashes (same as in tinyJoypadUtils.cpp)
+static bool pageHashes = true;
+static bool hashPass = true;
+static uint16_t pageHash[8];
+static uint16_t currentHash;
+
+// input
+static FILE *script = nullptr;
+static uint16_t framesLeft = 0;
+static uint16_t inputSeed = 1;
+
+// options
+static long maximumGames = 0;
+static const char *frameDirectory = nullptr;
+static FILE *i2cCapture = nullptr;
+
+// statistics
+static long frames = 0;
+static long displayedFrames = 0;
+static long pagesRendered = 0;
+static long pagesSent = 0;
+static long gamesWon = 0;
+static long gamesLost = 0;
+static unsigned long clicks = 0;
+static Status lastStatus = Status::intro;
+static std::chrono::steady_clock::time_point startTime;
+
+/*--------------------------------------------------------*/
+static void printStatistics()
+{
+  double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - startTime ).count();
+  long games = gamesWon + gamesLost;
+
+  fprintf( stderr, "games = %ld (won %ld, lost %ld), clicks per game = %.1f\n",
+           games, gamesWon, gamesLost, games ? double( clicks ) / games : 0.0 );
+  fprintf( stderr, "frames = %ld (%ld displayed), virtual time = %.1f s, real time = %.3f s\n",
+           frames, displayedFrames, hostVirtualMicros / 1e6, seconds );
+  fprintf( stderr, "pages sent = %ld of %ld\n", pagesSent, pagesRendered );
+  fprintf( stderr, "%.0f games/s, %.0f frames/s\n", games / seconds, frames / seconds );
+}
+
+/*--------------------------------------------------------*/
+// Reads the next step of the script, returns false at the end
+static bool readScriptStep()
+{
+  char line[128];
+  while ( fgets( line, sizeof( line ), script ) != nullptr )
+  {
+    char *comment = strchr( line, '#' );
+    if ( comment != nullptr ) { *comment = 0; }
+
+    unsigned count;
+    char names[16];
+    if ( ( sscanf( line, "%u %15s", &count, names ) != 2 ) || ( count == 0 ) ) { continue; }
+
+    buttons = 0;
+    for ( char *name = names; *name; name++ )
+    {
+      switch ( *name )
+      {
+        case 'L': buttons |= BUTTON_LEFT; break;
+        case 'R': buttons |= BUTTON_RIGHT; break;
+        case 'U': buttons |= BUTTON_UP; break;
+        case 'D': buttons |= BUTTON_DOWN; break;
+        case 'F': buttons |= BUTTON_FIRE; break;
+        case 'B': buttons |= BUTTON_FLAG; break;
+      }
+    }
+    framesLeft = count;
+    return( true );
+  }
+  return( false );
+}
+
+/*--------------------------------------------------------*/
+// A random player: short presses of a random button, followed by a pause.
+// Fire is pressed more often (and sometimes long enough to set a flag).
+static void randomStep()
+{
+  static bool pause = false;
+
+  inputSeed = xorshift16( inputSeed );
+  if ( pause )
+  {
+    buttons = 0;
+    framesLeft = 1 + ( inputSeed & 0x03 );
+  }
+  else
+  {
+    static const uint8_t choices[] = { BUTTON_LEFT, BUTTON_RIGHT, BUTTON_UP, BUTTON_DOWN, BUTTON_FIRE, BUTTON_FIRE };
+    buttons = choices[( inputSeed >> 8 ) % sizeof( choices )];
+    framesLeft = ( ( buttons == BUTTON_FIRE ) && ( ( inputSeed & 0x70 ) == 0 ) ) ? FLAG_PRESS_FRAMES + 2 : 1;
+  }
+  pause = !pause;
+}
+
+/*--------------------------------------------------------*/
+// Keeps track of the finished games (the status is checked once per frame)
+static void updateStatistics()
+{
+  Status status = game.getStatus();
+  if ( status != lastStatus )
+  {
+    if ( lastStatus == Status::playGame )
+    {
+      if ( status == Status::gameWon ) { gamesWon++; }
+      if ( status == Status::boom ) { gamesLost++; }
+      clicks += game.getClicksCount();
+    }
+    lastStatus = status;
+  }
+
+  if ( ( maximumGames > 0 ) && ( gamesWon + gamesLost >= maximumGames ) )
+  {
+    printStatistics();
+    exit( 0 );
+  }
+}
+
+/*--------------------------------------------------------*/
+// simulated tinyJoypadUtils
+void InitTinyJoypad() {}
+
+bool isLeftPressed() { return( buttons & BUTTON_LEFT ); }
+bool isRightPressed() { return( buttons & BUTTON_RIGHT ); }
+bool isUpPressed() { return( buttons & BUTTON_UP ); }
+bool isDownPressed() { return( buttons & BUTTON_DOWN ); }
+bool isFirePressed() { return( buttons & BUTTON_FIRE ); }
+bool isFlagPressed() { return( buttons & BUTTON_FLAG ); }
+
+void InitFrameTimer()
+{
+  nextFrameMicros = hostVirtualMicros + FRAME_TIME_MS * 1000UL;
+}
+
+/*--------------------------------------------------------*/
+// Advances the virtual clock to the next frame and reads the buttons for it
+void waitForNextFrame()
+{
+  // a frame which took too long restarts the schedule (like on the device)
+  if ( int32_t( hostVirtualMicros - nextFrameMicros ) > 0 )
+  {
+    nextFrameMicros = hostVirtualMicros;
+  }
+  hostVirtualMicros = nextFrameMicros;
+  nextFrameMicros += FRAME_TIME_MS * 1000UL;
+  frames++;
+
+  updateStatistics();
+
+  if ( framesLeft == 0 )
+  {
+    if ( script != nullptr )
+    {
+      if ( !readScriptStep() )
+      {
+        printStatistics();
+        exit( 0 );
+      }
+    }
+    else
+    {
+      randomStep();
+    }
+  }
+  framesLeft--;
+}
+
+void waitFrames( uint8_t count )
+{
+  while ( count-- != 0 ) { waitForNextFrame(); }
+}
+
+// the buttons only change between frames
+void waitUntilButtonsReleased()
+{
+  while ( buttons != 0 ) { waitForNextFrame(); }
+}
+
+void waitUntilButtonsReleased( const uint8_t delay )
+{
+  waitUntilButtonsReleased();
+  waitFrames( delay / FRAME_TIME_MS );
+}
+
+void _variableDelay_us( uint8_t delayValue ) { hostVirtualMicros += delayValue; }
+uint16_t getHardwareEntropy() { return( inputSeed ); }
+uint8_t getTimerJitter() { return( uint8_t( hostVirtualMicros >> 10 ) ); }
+
+// the sound is discarded, only its duration counts
+void Sound( const uint8_t freq, const uint8_t dur ) { hostVirtualMicros += uint32_t( dur ) * 2 * ( 255 - freq ); }
+
+/*--------------------------------------------------------*/
+// The I2C capture: one line per transaction (see 'tools/ssd1306_decoder.py')
+
+// same as 'ssd1306_init_sequence' in src/video/ssd1306xled.cpp
+static const uint8_t displayInitSequence[] = { 0xAE, 0xD5, 0xF0, 0xA8, 0x3F, 0xD3, 0x00, 0x40, 0x8D, 0x14, 0x20, 0x00,
+                                               0xA1, 0xC8, 0xDA, 0x12, 0x81, 0x3F, 0xD9, 0x22, 0xDB, 0x20, 0xA4, 0xA6,
+                                               0x2E, 0xAF };
+
+static void i2cStart( const uint8_t control ) { fprintf( i2cCapture, "3C: %02X", control ); }
+static void i2cWrite( const uint8_t value ) { fprintf( i2cCapture, " %02X", value ); }
+static void i2cStop() { fputc( '\n', i2cCapture ); }
+
+// like 'SSD1306Device::ssd1306_setpos()'
+static void i2cSetPosition( const uint8_t x, const uint8_t y )
+{
+  i2cStart( 0x00 );
+  i2cWrite( 0xb0 | ( y & 0x07 ) );
+  i2cWrite( 0x10 | ( x >> 4 ) );
+  i2cWrite( x & 0x0f );
+  i2cStop();
+}
+
+/*--------------------------------------------------------*/
+// like 'SSD1306Device::ssd1306_init()': the init sequence, then a cleared screen
+void InitDisplay()
+{
+  if ( i2cCapture == nullptr ) { return; }
+
+  i2cStart( 0x00 );
+  for ( uint8_t value : displayInitSequence ) { i2cWrite( value ); }
+  i2cStop();
+
+  i2cSetPosition( 0, 0 );
+  i2cStart( 0x40 );
+  for ( uint16_t n = 0; n < 128 * 8; n++ ) { i2cWrite( 0x00 ); }
+  i2cStop();
+}
+
+void TinyFlip_PrepareDisplayRow( uint8_t y )
+{
+  if ( pageHashes && hashPass )
+  {
+    currentHash = 0;
+    return;
+  }
+  displayRow = y;
+  displayColumn = 0;
+
+  if ( i2cCapture != nullptr )
+  {
+    i2cSetPosition( 0, y );
+    i2cStart( 0x40 );
+  }
+}
+
+void TinyFlip_SendPixels( uint8_t pixels )
+{
+  if ( pageHashes && hashPass )
+  {
+    currentHash = _crc_ccitt_update( currentHash, pixels );
+    return;
+  }
+  if ( displayColumn < 128 ) { frameBuffer[displayRow * 128 + displayColumn++] = pixels; }
+  if ( i2cCapture != nullptr ) { i2cWrite( pixels ); }
+}
+
+void TinyFlip_FinishDisplayRow()
+{
+  if ( pageHashes && hashPass ) { return; }
+  if ( i2cCapture != nullptr ) { i2cStop(); }
+}
+
+bool TinyFlip_PageChanged( uint8_t y )
+{
+  if ( pageHashes && hashPass )
+  {
+    pagesRendered++;
+    if ( currentHash == pageHash[y] ) { return( false ); }
+    pageHash[y] = currentHash;
+    hashPass = false;
+    return( true );
+  }
+  if ( !pageHashes ) { pagesRendered++; }
+  pagesSent++;
+  hashPass = true;
+  return( false );
+}
+
+/*--------------------------------------------------------*/
+// Writes the frame as PBM (if requested)
+void TinyFlip_DisplayBuffer()
+{
+  displayedFrames++;
+  // the decoder takes a snapshot at this marker
+  if ( i2cCapture != nullptr ) { fprintf( i2cCapture, "FRAME\n" ); }
+  if ( frameDirectory == nullptr ) { return; }
+
+  char fileName[256];
+  snprintf( fileName, sizeof( fileName ), "%s/frame_%06ld.pbm", frameDirectory, displayedFrames - 1 );
+  FILE *file = fopen( fileName, "wb" );
+  if ( file == nullptr ) { return; }
+
+  fprintf( file, "P4\n128 64\n" );
+  for ( uint8_t y = 0; y < 64; y++ )
+  {
+    for ( uint8_t x = 0; x < 128; x += 8 )
+    {
+      uint8_t packed = 0;
+      for ( uint8_t bit = 0; bit < 8; bit++ )
+      {
+        if ( frameBuffer[( y >> 3 ) * 128 + x + bit] & ( 1 << ( y & 0x07 ) ) ) { packed |= 0x80 >> bit; }
+      }
+      fputc( packed, file );
+    }
+  }
+  fclose( file );
+}
+
+void TinyFlip_SerialScreenshot() {}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  for ( int n = 1; n < argc; n++ )
+  {
+    bool hasValue = ( n + 1 < argc );
+    if ( ( strcmp( argv[n], "--script" ) == 0 ) && hasValue )
+    {
+      const char *fileName = argv[++n];
+      script = ( strcmp( fileName, "-" ) == 0 ) ? stdin : fopen( fileName, "r" );
+      if ( script == nullptr )
+      {
+        fprintf( stderr, "can't read '%s'\n", fileName );
+        return( 2 );
+      }
+    }
+    else if ( strcmp( argv[n], "--random" ) == 0 ) { script = nullptr; }
+    else if ( ( strcmp( argv[n], "--games" ) == 0 ) && hasValue ) { maximumGames = atol( argv[++n] ); }
+    else if ( ( strcmp( argv[n], "--seed" ) == 0 ) && hasValue ) { inputSeed = strtoul( argv[++n], nullptr, 0 ) | 1; }
+    else if ( ( strcmp( argv[n], "--frames" ) == 0 ) && hasValue ) { frameDirectory = argv[++n]; }
+    else if ( strcmp( argv[n], "--serial" ) == 0 ) { hostSerialOutput = stdout; }
+    else if ( strcmp( argv[n], "--no-page-hashes" ) == 0 ) { pageHashes = false; }
+    else if ( ( strcmp( argv[n], "--i2c" ) == 0 ) && hasValue )
+    {
+      const char *fileName = argv[++n];
+      i2cCapture = fopen( fileName, "w" );
+      if ( i2cCapture == nullptr )
+      {
+        fprintf( stderr, "can't write '%s'\n", fileName );
+        return( 2 );
+      }
+    }
+    else
+    {
+      fprintf( stderr, "usage: %s [--script <file>|-] [--random] [--games n] [--seed n] [--frames dir] [--serial] [--no-page-hashes] [--i2c file]\n", argv[0] );
+      return( 2 );
+    }
+  }
+
+  if ( ( script == nullptr ) && ( maximumGames == 0 ) ) { maximumGames = 1000; }
+
+  // a fresh EEPROM
+  memset( hostEEPROM, 0xff, sizeof( hostEEPROM ) );
+
+  startTime = std::chrono::steady_clock::now();
+
+  setup();
+  while ( true ) { loop(); }
+}
@@ -0,0 +1,155 @@
+// Plays seeded levels with a logical solver and reports win rate, clicks and
+// the time spent in the flood fill for every difficulty.
+//
+// Usage: solverBot [--games n] [--threads n] [--size WxH] [--json]
+//
+//   --games n   levels per difficulty (default 100000), seeds 1..n
+//   --threads n worker threads (default: all cores)
+//   --size WxH  level size (default 12x8), the mine counts are scaled to keep
+//               the density of the 12x8 level; for levels beyond 12x8 compile
+//               with -DHOST_MAX_GAME_COLS=... -DHOST_MAX_GAME_ROWS=...
+//   --json      one JSON object per difficulty instead of the table
+//
+// The solver is described in 'levelSolver.h'.
+
+#include <Arduino.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "levelSolver.h"
+
+// the difficulties of the 12x8 level (see TinyMinez.ino)
+static const uint8_t mineDifficulty[] = { 5, 10, 15, 20 };
+
+// the level generator uses a global random state
+static std::mutex levelMutex;
+
+/*--------------------------------------------------------*/
+struct Statistics
+{
+  long   games = 0;
+  long   won = 0;
+  long   guesses = 0;
+  double uncoverNanoseconds = 0.0;
+  double totalNanoseconds = 0.0;
+  std::vector<uint16_t> clicks;
+};
+
+static void playLevels( uint8_t width, uint8_t height, uint8_t mines, long firstSeed, long lastSeed, Statistics &statistics )
+{
+  auto start = std::chrono::steady_clock::now();
+
+  for ( long seed = firstSeed; seed <= lastSeed; seed++ )
+  {
+    VariableSizeGame game( width, height );
+    {
+      std::lock_guard<std::mutex> lock( levelMutex );
+      game.setSeed( seed );
+      game.createLevel( mines );
+    }
+    game.setStatus( Status::playGame );
+
+    Solver solver( game );
+    GameResult result = solver.play();
+
+    statistics.games++;
+    if ( result.won ) { statistics.won++; }
+    statistics.guesses += result.guesses;
+    statistics.uncoverNanoseconds += result.uncoverNanoseconds;
+    statistics.clicks.push_back( result.clicks );
+  }
+
+  statistics.totalNanoseconds = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count();
+}
+
+/*--------------------------------------------------------*/
+int main( int argc, char *argv[] )
+{
+  long games = 100000;
+  unsigned threads = std::max( 1u, std::thread::hardware_concurrency() );
+  unsigned width = 12;
+  unsigned height = 8;
+  bool jsonOutput = false;
+
+  for ( int n = 1; n < argc; n++ )
+  {
+    bool hasValue = ( n + 1 < argc );
+    if ( ( strcmp( argv[n], "--games" ) == 0 ) && hasValue ) { games = atol( argv[++n] ); }
+    else if ( ( strcmp( argv[n], "--threads" ) == 0 ) && hasValue ) { threads = std::max( 1, atoi( argv[++n] ) ); }
+    else if ( ( strcmp( argv[n], "--size" ) == 0 ) && hasValue && ( sscanf( argv[++n], "%ux%u", &width, &height ) == 2 ) ) {}
+    else if ( strcmp( argv[n], "--json" ) == 0 ) { jsonOutput = true; }
+    else
+    {
+      fprintf( stderr, "usage: %s [--games n] [--threads n] [--size WxH] [--json]\n", argv[0] );
+      return( 2 );
+    }
+  }
+
+  if ( ( width < 2 ) || ( height < 2 ) || ( width > MAX_GAME_COLS ) || ( height > MAX_GAME_ROWS ) )
+  {
+    fprintf( stderr, "level size must be between 2x2 and %ux%u\n", MAX_GAME_COLS, MAX_GAME_ROWS );
+    return( 2 );
+  }
+
+  if ( !jsonOutput )
+  {
+    printf( "level %ux%u, %ld games per difficulty, %u threads\n", width, height, games, threads );
+    printf( "mines  win rate  guesses/game  clicks p10/p50/p90/max  uncover us/game  uncover share\n" );
+  }
+
+  for ( uint8_t difficulty : mineDifficulty )
+  {
+    // same mine density as on the 12x8 level
+    uint8_t mines = std::max( 1u, ( difficulty * width * height + 48 ) / 96 );
+
+    std::vector<Statistics> results( threads );
+    std::vector<std::thread> workers;
+    for ( unsigned t = 0; t < threads; t++ )
+    {
+      long first = 1 + games * t / threads;
+      long last = games * ( t + 1 ) / threads;
+      workers.emplace_back( playLevels, width, height, mines, first, last, std::ref( results[t] ) );
+    }
+
+    Statistics total;
+    for ( unsigned t = 0; t < threads; t++ )
+    {
+      workers[t].join();
+      total.games += results[t].games;
+      total.won += results[t].won;
+      total.guesses += results[t].guesses;
+      total.uncoverNanoseconds += results[t].uncoverNanoseconds;
+      total.totalNanoseconds += results[t].totalNanoseconds;
+      total.clicks.insert( total.clicks.end(), results[t].clicks.begin(), results[t].clicks.end() );
+    }
+    if ( total.games == 0 ) { continue; }
+
+    std::sort( total.clicks.begin(), total.clicks.end() );
+    auto percentile = [&]( unsigned p ) { return( total.clicks[( total.clicks.size() - 1 ) * p / 100] ); };
+
+    double winRate = 100.0 * total.won / total.games;
+    double guessesPerGame = double( total.guesses ) / total.games;
+    double uncoverPerGame = total.uncoverNanoseconds / total.games / 1000.0;
+    double uncoverShare = 100.0 * total.uncoverNanoseconds / total.totalNanoseconds;
+
+    if ( jsonOutput )
+    {
+      printf( "{\"width\":%u,\"height\":%u,\"mines\":%u,\"games\":%ld,\"win_rate\":%.2f,\"guesses_per_game\":%.3f,"
+              "\"clicks_p10\":%u,\"clicks_p50\":%u,\"clicks_p90\":%u,\"clicks_max\":%u,"
+              "\"uncover_us_per_game\":%.3f,\"uncover_share\":%.1f}\n",
+              width, height, mines, total.games, winRate, guessesPerGame,
+              percentile( 10 ), percentile( 50 ), percentile( 90 ), percentile( 100 ), uncoverPerGame, uncoverShare );
+    }
+    else
+    {
+      printf( "%5u  %7.2f%%  %12.3f  %6u/%u/%u/%u  %15.3f  %12.1f%%\n",
+              mines, winRate, guessesPerGame,
+              percentile( 10 ), percentile( 50 ), percentile( 90 ), percentile( 100 ), uncoverPerGame, uncoverShare );
+    }
+  }
+
+  return( 0 );
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// Single threaded host: the block is executed exactly once.
+
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_FORCEON      1
+#define ATOMIC_BLOCK( type ) for ( bool _atomicOnce = true; _atomicOnce; _atomicOnce = false )
@@ -0,0 +1,12 @@
+#pragma once
+
+// C versions of the avr-libc CRC functions (same results as the inline assembler)
+
+#include <stdint.h>
+
+inline uint16_t _crc_ccitt_update( uint16_t crc, uint8_t data )
+{
+  data ^= uint8_t( crc );
+  data ^= uint8_t( data << 4 );
+  return( ( ( uint16_t( data ) << 8 ) | ( crc >> 8 ) ) ^ uint8_t( data >> 4 ) ^ ( uint16_t( data ) << 3 ) );
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// There is no need to wait on the host - time is only simulated.
+
+#include <stdint.h>
+
+// virtual time since start (in microseconds)
+extern uint32_t hostVirtualMicros;
+
+inline void _delay_ms( double ms ) { hostVirtualMicros += uint32_t( ms * 1000 ); }
+inline void _delay_us( double us ) { hostVirtualMicros += uint32_t( us ); }
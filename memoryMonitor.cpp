@@ -0,0 +1,71 @@
+#include <Arduino.h>
+#include "memoryMonitor.h"
+
+#ifdef MEMORY_MONITOR_ENABLED
+
+#if !(defined(__AVR_ATtiny85__)||defined(ARDUINO_AVR_ATTINYX4))
+  #include "SerialHexTools.h"
+#endif
+
+// provided by the linker and avr-libc
+extern uint8_t _end;
+extern uint8_t __stack;
+extern uint8_t __heap_start;
+extern char *__brkval;
+
+/*--------------------------------------------------------------*/
+// Paints the RAM between the static variables and the top of the stack with the canary.
+// This runs in section .init3 (after the stack pointer is set up, but before
+// any function call), so nothing is in use yet.
+void memoryMonitorPaintStack() __attribute__ ( ( naked, used, section( ".init3" ) ) );
+void memoryMonitorPaintStack()
+{
+  uint8_t *p = &_end;
+
+  while ( p <= &__stack )
+  {
+    *p++ = STACK_CANARY;
+  }
+}
+
+/*--------------------------------------------------------------*/
+// the lowest address the stack may use (the heap ends here)
+static uint8_t *getHeapEnd()
+{
+  return( ( __brkval != nullptr ) ? (uint8_t *)__brkval : &__heap_start );
+}
+
+/*--------------------------------------------------------------*/
+// Returns the number of bytes which were never touched by the stack since reset.
+uint16_t memoryMonitorStackHeadroom()
+{
+  uint8_t *p = getHeapEnd();
+  uint16_t count = 0;
+
+  while ( ( p <= &__stack ) && ( *p == STACK_CANARY ) )
+  {
+    p++;
+    count++;
+  }
+
+  return( count );
+}
+
+/*--------------------------------------------------------------*/
+// Returns the number of bytes currently available between heap and stack.
+uint16_t memoryMonitorFreeRam()
+{
+  return( (uint8_t *)SP - getHeapEnd() );
+}
+
+/*--------------------------------------------------------------*/
+void memoryMonitorReport( const bool levelIntact )
+{
+#if defined(HAVE_SERIAL_HEX)
+  Serial.print( F("stack headroom = ") ); Serial.print( memoryMonitorStackHeadroom() );
+  Serial.print( F(" bytes, free RAM = ") ); Serial.print( memoryMonitorFreeRam() );
+  Serial.println( levelIntact ? F(" bytes, levelData intact") : F(" bytes, *** levelData overwritten! ***") );
+#endif
+}
+
+#endif
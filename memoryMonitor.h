@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Enable the memory monitor: the free RAM is painted with a canary pattern at
+// startup, so the stack's high-water mark can be determined at any time. 'levelData'
+// is guarded by sentinels (see Game::isLevelIntact()).
+// The debug builds print the margins after each game.
+//#define MEMORY_MONITOR_ENABLED
+// show the stack headroom (in bytes, 99 = 99 or more) in the dashboard (row 5)
+//#define MEMORY_MONITOR_OVERLAY
+
+#ifdef MEMORY_MONITOR_ENABLED
+  // fill value for the unused RAM
+  const uint8_t STACK_CANARY = 0xc5;
+  // fill value for the sentinels around 'levelData'
+  const uint16_t LEVEL_GUARD = 0xa55a;
+
+  uint16_t memoryMonitorStackHeadroom();
+  uint16_t memoryMonitorFreeRam();
+  void     memoryMonitorReport( const bool levelIntact );
+#endif
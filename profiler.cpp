@@ -0,0 +1,144 @@
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "profiler.h"
+#include "src/video/WireWrap.h"
+
+#ifdef PROFILER_ENABLED
+
+#ifdef WIREWRAP_USI_ISR
+  #error "WIREWRAP_USI_ISR clocks the display with timer 1, the profiler needs it too"
+#endif
+
+#if !(defined(__AVR_ATtiny85__)||defined(ARDUINO_AVR_ATTINYX4))
+  #include "SerialHexTools.h"
+#endif
+
+struct ProfilerStatistics
+{
+  uint16_t start;
+  uint16_t minimum;
+  uint16_t maximum;
+  uint16_t count;
+  uint32_t sum;
+};
+
+static ProfilerStatistics statistics[PROFILE_SECTIONS];
+
+#if defined(__AVR_ATtiny85__)
+// timer 1 has only 8 bits, the upper byte is counted by the overflow interrupt
+static volatile uint8_t timerHighByte = 0;
+
+ISR( TIMER1_OVF_vect )
+{
+  timerHighByte++;
+}
+#endif
+
+/*--------------------------------------------------------------*/
+// Starts timer 1 with a prescaler of 64
+void profilerInit()
+{
+#if defined(__AVR_ATtiny85__)
+  TCCR1 = ( 1 << CS12 ) | ( 1 << CS11 ) | ( 1 << CS10 );
+  TIMSK |= ( 1 << TOIE1 );
+#else
+  TCCR1A = 0;
+  TCCR1B = ( 1 << CS11 ) | ( 1 << CS10 );
+#endif
+  profilerReset();
+}
+
+/*--------------------------------------------------------------*/
+uint16_t profilerTicks()
+{
+#if defined(__AVR_ATtiny85__)
+  uint8_t high;
+  uint8_t low;
+  ATOMIC_BLOCK( ATOMIC_RESTORESTATE )
+  {
+    high = timerHighByte;
+    low = TCNT1;
+    // overflow not yet handled by the interrupt?
+    if ( ( TIFR & ( 1 << TOV1 ) ) && ( low < 0x80 ) ) { high++; }
+  }
+  return( ( uint16_t( high ) << 8 ) | low );
+#else
+  uint16_t ticks;
+  ATOMIC_BLOCK( ATOMIC_RESTORESTATE )
+  {
+    ticks = TCNT1;
+  }
+  return( ticks );
+#endif
+}
+
+/*--------------------------------------------------------------*/
+void profilerBegin( const uint8_t section )
+{
+  statistics[section].start = profilerTicks();
+}
+
+/*--------------------------------------------------------------*/
+void profilerEnd( const uint8_t section )
+{
+  ProfilerStatistics *entry = &statistics[section];
+  uint16_t duration = profilerTicks() - entry->start;
+
+  if ( duration < entry->minimum ) { entry->minimum = duration; }
+  if ( duration > entry->maximum ) { entry->maximum = duration; }
+  entry->sum += duration;
+  entry->count++;
+}
+
+/*--------------------------------------------------------------*/
+void profilerReset()
+{
+  for ( uint8_t n = 0; n < PROFILE_SECTIONS; n++ )
+  {
+    statistics[n].minimum = 0xffff;
+    statistics[n].maximum = 0;
+    statistics[n].count = 0;
+    statistics[n].sum = 0;
+  }
+}
+
+/*--------------------------------------------------------------*/
+uint16_t profilerGetMin( const uint8_t section )
+{
+  return( statistics[section].count ? statistics[section].minimum : 0 );
+}
+
+/*--------------------------------------------------------------*/
+uint16_t profilerGetMax( const uint8_t section )
+{
+  return( statistics[section].maximum );
+}
+
+/*--------------------------------------------------------------*/
+uint16_t profilerGetAverage( const uint8_t section )
+{
+  return( statistics[section].count ? statistics[section].sum / statistics[section].count : 0 );
+}
+
+/*--------------------------------------------------------------*/
+// prints all sections (in us) to the serial port
+void profilerPrint()
+{
+#if defined(HAVE_SERIAL_HEX)
+  static const char *names[PROFILE_SECTIONS] = { "frame", "render", "display", "uncover", "createLevel" };
+
+  Serial.println( F("section        count     min[us]   avg[us]   max[us]") );
+  for ( uint8_t n = 0; n < PROFILE_SECTIONS; n++ )
+  {
+    Serial.print( names[n] );
+    for ( uint8_t pad = strlen( names[n] ); pad < 15; pad++ ) { Serial.print( ' ' ); }
+    Serial.print( statistics[n].count ); Serial.print( F("\t  ") );
+    Serial.print( uint32_t( profilerGetMin( n ) ) * 4 ); Serial.print( F("\t    ") );
+    Serial.print( uint32_t( profilerGetAverage( n ) ) * 4 ); Serial.print( F("\t      ") );
+    Serial.println( uint32_t( profilerGetMax( n ) ) * 4 );
+  }
+#endif
+}
+
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Enable the profiler: named sections are timed with timer 1 (4us resolution @16MHz)
+// and min/max/average are collected. Without this define all PROFILE_xxx() macros
+// compile to nothing.
+//#define PROFILER_ENABLED
+// show the average busy time per frame (in ms) in the dashboard (row 2)
+//#define PROFILER_OVERLAY
+
+enum ProfilerSection : uint8_t
+{
+  PROFILE_FRAME,          // everything between two 'waitForNextFrame()' calls
+  PROFILE_RENDER,         // Tiny_Flip() (including the I2C transfer on the ATtiny)
+  PROFILE_DISPLAY,        // pushing the buffer to the display (Adafruit_SSD1306 only)
+  PROFILE_UNCOVER,        // Game::uncoverCells()
+  PROFILE_CREATE_LEVEL,   // Game::createLevel()
+  PROFILE_SECTIONS,
+};
+
+#ifdef PROFILER_ENABLED
+  #define PROFILE_INIT()            profilerInit()
+  #define PROFILE_BEGIN( section )  profilerBegin( section )
+  #define PROFILE_END( section )    profilerEnd( section )
+  // prints the statistics (serial boards only) and starts over
+  #define PROFILE_REPORT()          { profilerPrint(); profilerReset(); }
+
+  // one tick is 64 CPU cycles
+  const uint16_t PROFILER_TICKS_PER_MS = F_CPU / 64 / 1000;
+
+  void     profilerInit();
+  uint16_t profilerTicks();
+  void     profilerBegin( const uint8_t section );
+  void     profilerEnd( const uint8_t section );
+  void     profilerReset();
+  uint16_t profilerGetMin( const uint8_t section );
+  uint16_t profilerGetMax( const uint8_t section );
+  uint16_t profilerGetAverage( const uint8_t section );
+  void     profilerPrint();
+#else
+  #define PROFILE_INIT()
+  #define PROFILE_BEGIN( section )
+  #define PROFILE_END( section )
+  #define PROFILE_REPORT()
+#endif
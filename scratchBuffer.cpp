@@ -0,0 +1,46 @@
+#include <Arduino.h>
+#include "scratchBuffer.h"
+
+// the one and only scratch buffer
+uint8_t scratchBuffer[SCRATCH_BUFFER_SIZE];
+
+#ifdef SCRATCH_BUFFER_CHECKS
+
+static ScratchOwner scratchOwner = SCRATCH_FREE;
+
+/*--------------------------------------------------------------*/
+// reports an overlapping lifetime and stops
+static void scratchConflict( const ScratchOwner owner )
+{
+  Serial.print( F("*** scratch buffer : requested by ") );
+  Serial.print( owner );
+  Serial.print( F(", owned by ") );
+  Serial.print( scratchOwner );
+  Serial.println( F(" ***") );
+  while( 1 );
+}
+
+/*--------------------------------------------------------------*/
+// Returns the buffer, if it's free (or already owned by 'owner')
+uint8_t *scratchAcquire( const ScratchOwner owner )
+{
+  if ( ( scratchOwner != SCRATCH_FREE ) && ( scratchOwner != owner ) )
+  {
+    scratchConflict( owner );
+  }
+  scratchOwner = owner;
+
+  return( scratchBuffer );
+}
+
+/*--------------------------------------------------------------*/
+void scratchRelease( const ScratchOwner owner )
+{
+  if ( scratchOwner != owner )
+  {
+    scratchConflict( owner );
+  }
+  scratchOwner = SCRATCH_FREE;
+}
+
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+
+// One 128 byte RAM region shared by all short lived buffers:
+// - the text buffer (dashboard digits or zoomed text, see textUtils.h)
+// - one decompressed bitmap row (see displayBitmapRow())
+// - temporary data of the solver or other game logic
+//
+// Only one owner may use the buffer at a time. With SCRATCH_BUFFER_CHECKS
+// every 'scratchAcquire()' verifies that the buffer was released by the
+// previous owner, otherwise the offending owners are printed and the program stops.
+const uint8_t SCRATCH_BUFFER_SIZE = 128;
+
+#if !(defined(__AVR_ATtiny85__)||defined(ARDUINO_AVR_ATTINYX4))
+  #define SCRATCH_BUFFER_CHECKS
+#endif
+
+enum ScratchOwner : uint8_t
+{
+  SCRATCH_FREE,
+  SCRATCH_TEXT,
+  SCRATCH_BITMAP_ROW,
+  SCRATCH_SOLVER,
+};
+
+extern uint8_t scratchBuffer[SCRATCH_BUFFER_SIZE];
+
+#ifdef SCRATCH_BUFFER_CHECKS
+  uint8_t *scratchAcquire( const ScratchOwner owner );
+  void scratchRelease( const ScratchOwner owner );
+#else
+  inline uint8_t *scratchAcquire( const ScratchOwner owner ) { return( scratchBuffer ); }
+  inline void scratchRelease( const ScratchOwner owner ) {}
+#endif
+
+// typed view of the buffer, e.g. 'SolverData *data = scratchAcquireAs<SolverData>( SCRATCH_SOLVER );'
+template <typename T> T *scratchAcquireAs( const ScratchOwner owner )
+{
+  static_assert( sizeof( T ) <= SCRATCH_BUFFER_SIZE, "type doesn't fit into the scratch buffer" );
+  return( reinterpret_cast<T *>( scratchAcquire( owner ) ) );
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Generated by host/seedBank.cpp (--seeds 65535 --count 16 --min-clicks 3 --min-subset 0), do not edit.
+// Seeds of 12x8 levels which can be solved without guessing, when the first
+// click goes to the center (where the cursor starts). One row per difficulty.
+
+const uint8_t SEED_BANK_SIZE = 16;
+
+const uint16_t seedBank[][SEED_BANK_SIZE] PROGMEM =
+{
+  // 5 mines
+  {
+    5, 6, 8, 10, 11, 12, 13, 14,
+    15, 16, 18, 20, 22, 25, 26, 30
+  },
+  // 10 mines
+  {
+    6, 8, 10, 11, 12, 13, 14, 18,
+    20, 22, 25, 26, 41, 47, 54, 56
+  },
+  // 15 mines
+  {
+    10, 12, 13, 25, 26, 64, 73, 74,
+    86, 126, 145, 160, 230, 235, 237, 243
+  },
+  // 20 mines
+  {
+    360, 388, 419, 484, 505, 721, 763, 812,
+    907, 991, 1138, 1198, 1416, 1528, 1545, 1565
+  },
+};
@@ -0,0 +1,160 @@
+/* Interrupt driven TWI transmitter for ATmega targets
+
+   Unlike Wire (32 byte buffer, blocking endTransmission()) the bytes are streamed
+   from a ring buffer by the TWI interrupt, a transaction can have any length and
+   is never re-addressed. write() only blocks while the ring buffer is full,
+   stop() is queued, so a full SSD1306 frame is one continuous transfer which runs
+   in the background.
+
+   While the buffer is empty the TWI holds SCL low (TWINT stays set) until
+   the next write() or stop(). start() waits for the address to be acknowledged
+   and returns false otherwise. A NACK or a lost arbitration ends the transaction,
+   the remaining bytes and all further write()/stop() calls of it are dropped.
+
+   Used by ssd1306xled, the ATmega debug build drives the display with it instead
+   of Adafruit_SSD1306 (see tinyJoypadUtils.cpp), Wire can't be linked together
+   with this TWI interrupt.
+*/
+
+#include "WireWrap.h"
+#include <avr/io.h>
+
+#if defined(WIREWRAP_ATMEGA_TWI) && defined(TWCR)
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include <util/twi.h>
+
+// SCL frequency, the SSD1306 is specified for 400kHz, most modules work up to 1MHz
+#ifndef ATMEGA_TWI_FREQUENCY
+#  define ATMEGA_TWI_FREQUENCY 400000UL
+#endif
+
+// prescaler 1: SCL = F_CPU / ( 16 + 2 * TWBR )
+#define ATMEGA_TWI_BITRATE ( ( F_CPU / ATMEGA_TWI_FREQUENCY - 16 ) / 2 )
+static_assert( ( F_CPU / ATMEGA_TWI_FREQUENCY >= 16 ) && ( ATMEGA_TWI_BITRATE <= 255 ), "ATMEGA_TWI_FREQUENCY out of range" );
+
+namespace {
+  const uint8_t TWCR_START = 1 << TWINT | 1 << TWSTA | 1 << TWEN | 1 << TWIE;
+  const uint8_t TWCR_SEND  = 1 << TWINT | 1 << TWEN | 1 << TWIE;
+  const uint8_t TWCR_STOP  = 1 << TWINT | 1 << TWSTO | 1 << TWEN;
+  // TWINT stays set, SCL is held low
+  const uint8_t TWCR_HOLD  = 1 << TWEN;
+
+  // must be a power of 2
+  const uint8_t RING_SIZE = 32;
+
+  enum TwiState : uint8_t { TWI_IDLE, TWI_SENDING, TWI_WAITING };
+
+  uint8_t ring[RING_SIZE];
+  volatile uint8_t ringHead = 0;
+  volatile uint8_t ringTail = 0;
+  volatile TwiState twiState = TWI_IDLE;
+  volatile bool stopPending = false;
+  uint8_t slaveAddress;
+
+  // called with interrupts disabled
+  void sendNext() {
+    uint8_t tail = ringTail;
+    if (tail != ringHead) {
+      TWDR = ring[tail];
+      ringTail = (tail + 1) & (RING_SIZE - 1);
+      TWCR = TWCR_SEND;
+      twiState = TWI_SENDING;
+    } else if (stopPending) {
+      TWCR = TWCR_STOP;
+      stopPending = false;
+      twiState = TWI_IDLE;
+    } else {
+      TWCR = TWCR_HOLD;
+      twiState = TWI_WAITING;
+    }
+  }
+}
+
+namespace wirerap {
+
+  ISR(TWI_vect) {
+    switch (TW_STATUS) {
+      case TW_START:
+      case TW_REP_START:
+        TWDR = slaveAddress << 1 | TW_WRITE;
+        TWCR = TWCR_SEND;
+        break;
+
+      case TW_MT_SLA_ACK:
+      case TW_MT_DATA_ACK:
+        sendNext();
+        break;
+
+      default:
+        // NACK or arbitration lost, give up this transaction
+        ringTail = ringHead;
+        stopPending = false;
+        TWCR = TWCR_STOP;
+        twiState = TWI_IDLE;
+        break;
+    }
+  }
+
+  void AtmegaTwi::init() {
+    // internal pullups (like Wire)
+    digitalWrite(SDA, HIGH);
+    digitalWrite(SCL, HIGH);
+
+    TWSR = 0;                                 // prescaler 1
+    TWBR = ATMEGA_TWI_BITRATE;
+    TWCR = 1 << TWEN;
+  }
+
+  bool AtmegaTwi::start(uint8_t addr) {
+    // wait for the previous transaction, an open one (no stop) gets a repeated start
+    while (twiState == TWI_SENDING);
+    while (TWCR & 1 << TWSTO);
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      slaveAddress = addr;
+      twiState = TWI_SENDING;
+      TWCR = TWCR_START;
+    }
+    // the buffer is empty, so the transfer waits after the address (or failed)
+    while (twiState == TWI_SENDING);
+    return twiState != TWI_IDLE;
+  }
+
+  void AtmegaTwi::write(uint8_t data) {
+    uint8_t head = ringHead;
+    uint8_t next = (head + 1) & (RING_SIZE - 1);
+    // wait for a free slot (the interrupt empties the buffer)
+    while ((next == ringTail) && (twiState != TWI_IDLE));
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      // no transaction (failed start or NACK), nobody would send the byte
+      if (twiState == TWI_IDLE) { return; }
+      ring[head] = data;
+      ringHead = next;
+      if (twiState == TWI_WAITING) { sendNext(); }
+    }
+  }
+
+  void AtmegaTwi::stop() {
+    // nothing to do in TWI_IDLE: the stop condition was sent already (or the transaction failed)
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      if (twiState == TWI_WAITING) {
+        stopPending = true;
+        sendNext();
+      } else if (twiState == TWI_SENDING) {
+        stopPending = true;
+      }
+    }
+  }
+
+  // wait until all bytes are on the bus (the stop condition, if one was requested)
+  void AtmegaTwi::flush() {
+    while (twiState == TWI_SENDING);
+  }
+
+}
+
+#endif
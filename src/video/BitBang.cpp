@@ -11,6 +11,10 @@ namespace wirerap {
   uint8_t Core::reg;
 #endif
 
+#ifdef WIREWRAP_TINY_I2C
+  TinyI2CMaster Tiny::i2c;
+#endif
+
 #define I2C_PORT  PORTA
 #define I2C_DDR DDRA
 #define SSD1306_SCL   PORTA4 //PORTB4  // SCL, Pin 4 on SSD1306 Board - for webbogles board
@@ -13,21 +13,22 @@
 
 #include <Arduino.h>
 #include <avr/io.h>
-#include <util/delay.h>
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+#include <util/delay_basic.h>
 
 // Defines
-#define TWI_FAST_MODE
-
-#ifdef TWI_FAST_MODE                 // TWI FAST mode timing limits. SCL = 100-400kHz
-#define DELAY_T2TWI (_delay_us(2))   // >1.3us
-#define DELAY_T4TWI (_delay_us(1))   // >0.6us
-#else                                // TWI STANDARD mode timing limits. SCL <= 100kHz
-#define DELAY_T2TWI (_delay_us(5))   // >4.7us
-#define DELAY_T4TWI (_delay_us(4))   // >4.0us
-#endif
+#define DELAY_T2TWI (delayT2())
+#define DELAY_T4TWI (delayT4())
 
 #define TWI_NACK_BIT 0 // Bit position for (N)ACK bit.
 
+// number of start/write/stop sequences which must succeed at a speed
+#define PROBE_ROUNDS 16
+
+// _delay_loop_1() takes 3 cycles per loop
+#define NS_TO_LOOPS(ns) ((F_CPU / 1000000UL * (ns) + 2999) / 3000)
+
 // Constants
 namespace {
 // Prepare register value to: Clear flags, and set USI to shift 8 bits i.e. count 16 clock edges.
@@ -35,10 +36,70 @@ const unsigned char USISR_8bit = 1 << USISIF | 1 << USIOIF | 1 << USIPF | 1 << U
 // Prepare register value to: Clear flags, and set USI to shift 1 bit i.e. count 2 clock edges.
 const unsigned char USISR_1bit = 1 << USISIF | 1 << USIOIF | 1 << USIPF | 1 << USIDC | 0xE << USICNT0;
 
+// T2 (SCL low) and T4 (SCL high) delays of every speed
+const uint8_t speedLoops[I2C_SPEEDS][2] PROGMEM = {
+  { NS_TO_LOOPS(5000), NS_TO_LOOPS(4000) },   // standard: >4.7us, >4.0us
+  { NS_TO_LOOPS(2000), NS_TO_LOOPS(1000) },   // fast: >1.3us, >0.6us
+  { NS_TO_LOOPS(500), NS_TO_LOOPS(260) },     // fast plus: >0.5us, >0.26us
+  { 0, 0 },                                   // turbo: out of spec, many SSD1306 modules don't mind
+};
+
 }
 
 TinyI2CMaster::TinyI2CMaster()
 {
+  setSpeed(I2C_FAST);
+}
+
+void TinyI2CMaster::delayT2() {
+  if (loopsT2) _delay_loop_1(loopsT2);
+}
+
+void TinyI2CMaster::delayT4() {
+  if (loopsT4) _delay_loop_1(loopsT4);
+}
+
+void TinyI2CMaster::setSpeed(uint8_t newSpeed) {
+  speed = newSpeed;
+  loopsT2 = pgm_read_byte(&speedLoops[newSpeed][0]);
+  loopsT4 = pgm_read_byte(&speedLoops[newSpeed][1]);
+}
+
+// Checks if the slave acknowledges reliably at the current speed
+bool TinyI2CMaster::probe(uint8_t address) {
+  for (uint8_t n = 0; n < PROBE_ROUNDS; n++) {
+    // the control byte 0x00 without a command does nothing on the SSD1306
+    bool ok = start(address, 0) && write(0x00);
+    stop();
+    if (!ok) return false;
+  }
+  return true;
+}
+
+// Selects the speed one step below the fastest at which the slave acknowledges:
+// the probe only checks ACKs, data bits may already be corrupted at the fastest
+// passing speed. The result is cached in EEPROM, the ladder is only probed again
+// if the cached speed fails. Writing 0xFF to TINY_I2C_SPEED_EEPROM clears the cache.
+uint8_t TinyI2CMaster::selectSpeed(uint8_t address) {
+  uint8_t cached = eeprom_read_byte((const uint8_t *)TINY_I2C_SPEED_EEPROM);
+  if (cached < I2C_TURBO) {
+    setSpeed(cached);
+    if (probe(address)) return cached;
+  }
+
+  for (uint8_t newSpeed = I2C_TURBO; newSpeed > I2C_STANDARD; newSpeed--) {
+    setSpeed(newSpeed);
+    if (probe(address)) {
+      // keep a margin, I2C_TURBO is never selected
+      setSpeed(--newSpeed);
+      eeprom_update_byte((uint8_t *)TINY_I2C_SPEED_EEPROM, newSpeed);
+      return newSpeed;
+    }
+  }
+
+  // standard mode (no display connected yet?), not cached, so the next start probes again
+  setSpeed(I2C_STANDARD);
+  return I2C_STANDARD;
 }
 
 // Minimal Tiny I2C Routines **********************************************
@@ -125,11 +186,7 @@ bool TinyI2CMaster::start (uint8_t address, int readcount) {
   /* Release SCL to ensure that (repeated) Start can be performed */
   PORT_USI_CL |= 1 << PIN_USI_SCL;            // Release SCL.
   while (!(PIN_USI_CL & 1 << PIN_USI_SCL));   // Verify that SCL becomes high.
-#ifdef TWI_FAST_MODE
-  DELAY_T4TWI;
-#else
-  DELAY_T2TWI;
-#endif
+  if (speed == I2C_STANDARD) DELAY_T2TWI; else DELAY_T4TWI;
 
   /* Generate Start Condition */
   PORT_USI &= ~(1 << PIN_USI_SDA);            // Force SDA LOW.
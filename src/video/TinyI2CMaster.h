@@ -14,6 +14,20 @@
 
 #include <stdint.h>
 
+// bus speeds (half bit delays, see TinyI2CMaster.cpp)
+enum TinyI2CSpeed : uint8_t {
+  I2C_STANDARD,                      // 100kHz
+  I2C_FAST,                          // 400kHz
+  I2C_FAST_PLUS,                     // 1MHz
+  I2C_TURBO,                         // no delays, as fast as the CPU can toggle the pins
+  I2C_SPEEDS
+};
+
+// EEPROM byte which caches the speed found by selectSpeed() (see eepromLayout.h), 0xFF = probe again
+#ifndef TINY_I2C_SPEED_EEPROM
+#  define TINY_I2C_SPEED_EEPROM 0x1FF
+#endif
+
 
 class TinyI2CMaster {
 
@@ -26,9 +40,19 @@ class TinyI2CMaster {
     bool start(uint8_t address, int readcount);
     bool restart(uint8_t address, int readcount);
     void stop();
+    void setSpeed(uint8_t speed);
+    uint8_t getSpeed() { return speed; }
+    bool probe(uint8_t address);
+    uint8_t selectSpeed(uint8_t address);
 
   private:
     int I2Ccount;
+    uint8_t speed;
+    // delay loop counts (3 cycles each) for the current speed
+    uint8_t loopsT2;
+    uint8_t loopsT4;
+    void delayT2();
+    void delayT4();
     uint8_t transfer(uint8_t data);
 };
 
@@ -0,0 +1,195 @@
+/* Interrupt driven USI I2C transmitter
+
+   The bytes written by the display driver go to a small ring buffer and are
+   shifted out by the USI in the background: timer 1 (CTC mode) toggles SCL
+   for every half bit, the USI counter overflow interrupt handles the (N)ACK bit
+   and loads the next byte. While a byte is on the bus the CPU renders the
+   following ones, so a frame takes about max(render, transmit) instead of
+   the sum of both.
+
+   The USI can't generate SCL on its own, so every clock edge costs an interrupt
+   (~16 cycles). Choose USI_I2C_SCL_FREQUENCY so that enough time is left for
+   rendering. Timer 1 belongs to this driver (the profiler can't be enabled),
+   timer 0 stays with the core (millis()) and the entropy sources.
+
+   start() and stop() wait until the buffer is empty, the (N)ACK of the slave
+   is not checked (like the bit bang driver).
+*/
+
+#include "WireWrap.h"
+
+#ifdef WIREWRAP_USI_ISR
+
+#include <Arduino.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include <util/delay.h>
+
+// SCL frequency, the maximum depends on the CPU clock (see below)
+#ifndef USI_I2C_SCL_FREQUENCY
+#  define USI_I2C_SCL_FREQUENCY 200000UL
+#endif
+
+// timer 1 compare match for every half bit
+#define USI_TIMER_TOP ( F_CPU / ( 2 * USI_I2C_SCL_FREQUENCY ) - 1 )
+static_assert( USI_TIMER_TOP >= 23, "USI_I2C_SCL_FREQUENCY too high, the clock interrupt would use all of the CPU time" );
+static_assert( USI_TIMER_TOP <= 255, "USI_I2C_SCL_FREQUENCY too low for timer 1" );
+
+#if defined(TIMSK1)
+#  define USI_TIMSK TIMSK1
+#  define USI_TIFR  TIFR1
+#else
+#  define USI_TIMSK TIMSK
+#  define USI_TIFR  TIFR
+#endif
+
+// I2C start/stop timing (fast mode)
+#define DELAY_T2TWI (_delay_us(2))   // >1.3us
+#define DELAY_T4TWI (_delay_us(1))   // >0.6us
+
+namespace {
+  // two-wire mode, overflow interrupt, counter clocked by USITC, toggle SCL
+  const uint8_t USI_STROBE = 1 << USIOIE | 1 << USIWM1 | 1 << USICS1 | 1 << USICLK | 1 << USITC;
+  // same without toggling SCL
+  const uint8_t USI_CONTROL = 1 << USIWM1 | 1 << USICS1 | 1 << USICLK;
+  // clear flags, count 16 clock edges (8 bits)
+  const uint8_t USISR_8bit = 1 << USISIF | 1 << USIOIF | 1 << USIPF | 1 << USIDC | 0x0 << USICNT0;
+  // clear flags, count 2 clock edges (1 bit)
+  const uint8_t USISR_1bit = 1 << USISIF | 1 << USIOIF | 1 << USIPF | 1 << USIDC | 0xE << USICNT0;
+
+  // must be a power of 2
+  const uint8_t RING_SIZE = 16;
+
+  enum UsiState : uint8_t { USI_IDLE, USI_SEND_DATA, USI_RECEIVE_ACK };
+
+  uint8_t ring[RING_SIZE];
+  volatile uint8_t ringHead = 0;
+  volatile uint8_t ringTail = 0;
+  volatile UsiState usiState = USI_IDLE;
+}
+
+namespace wirerap {
+
+  // Generates one SCL edge (the USI counts it and shifts on the rising edge).
+  // Naked, because 'ldi' and 'out' don't change any flags.
+  ISR(TIM1_COMPA_vect, ISR_NAKED) {
+    asm volatile(
+      "push r24            \n\t"
+      "ldi  r24, %[strobe] \n\t"
+      "out  %[usicr], r24  \n\t"
+      "pop  r24            \n\t"
+      "reti                \n\t"
+      :: [strobe] "M" (USI_STROBE), [usicr] "I" (_SFR_IO_ADDR(USICR)));
+  }
+
+  // A byte or the (N)ACK bit is complete.
+  ISR(USI_OVF_vect) {
+    if (usiState == USI_SEND_DATA) {
+      // release SDA, so the slave can acknowledge
+      DDR_USI &= ~(1 << PIN_USI_SDA);
+      USISR = USISR_1bit;
+      usiState = USI_RECEIVE_ACK;
+      return;
+    }
+
+    DDR_USI |= 1 << PIN_USI_SDA;
+    uint8_t tail = ringTail;
+    if (tail != ringHead) {
+      USIDR = ring[tail];
+      ringTail = (tail + 1) & (RING_SIZE - 1);
+      USISR = USISR_8bit;
+      usiState = USI_SEND_DATA;
+    } else {
+      // nothing to send, keep SCL low until the next write()
+      USIDR = 0xFF;
+      USISR = USISR_8bit;
+      USI_TIMSK &= ~(1 << OCIE1A);
+      usiState = USI_IDLE;
+    }
+  }
+
+  void UsiBuffered::init() {
+    PORT_USI |= 1 << PIN_USI_SDA;             // Enable pullup on SDA.
+    PORT_USI_CL |= 1 << PIN_USI_SCL;          // Enable pullup on SCL.
+
+    DDR_USI_CL |= 1 << PIN_USI_SCL;           // Enable SCL as output.
+    DDR_USI |= 1 << PIN_USI_SDA;              // Enable SDA as output.
+
+    USIDR = 0xFF;                             // Preload data register with "released level" data.
+    USICR = USI_CONTROL;
+    USISR = USISR_8bit;
+
+    // timer 1 paces the SCL edges
+  #if defined(TCCR1)
+    // ATtiny85: CTC clears at OCR1C, the interrupt fires at OCR1A
+    TCCR1 = 1 << CTC1 | 1 << CS10;            // CTC mode, no prescaler
+    OCR1C = USI_TIMER_TOP;
+  #else
+    TCCR1A = 0;
+    TCCR1B = 1 << WGM12 | 1 << CS10;          // CTC mode, no prescaler
+  #endif
+    OCR1A = USI_TIMER_TOP;
+  }
+
+  void UsiBuffered::write(uint8_t data) {
+    uint8_t head = ringHead;
+    uint8_t next = (head + 1) & (RING_SIZE - 1);
+    // wait for a free slot (the interrupts empty the buffer)
+    while (next == ringTail);
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      if (usiState == USI_IDLE) {
+        // the buffer is empty and SCL is low, start shifting right away
+        USIDR = data;
+        USISR = USISR_8bit;
+        usiState = USI_SEND_DATA;
+        TCNT1 = 0;
+        USI_TIFR = 1 << OCF1A;
+        USI_TIMSK |= 1 << OCIE1A;
+      } else {
+        ring[head] = data;
+        ringHead = next;
+      }
+    }
+  }
+
+  // wait until all bytes are on the bus
+  void UsiBuffered::flush() {
+    while (usiState != USI_IDLE);
+  }
+
+  bool UsiBuffered::start(uint8_t addr) {
+    flush();
+
+    /* Release SCL to ensure that (repeated) Start can be performed */
+    PORT_USI_CL |= 1 << PIN_USI_SCL;          // Release SCL.
+    while (!(PIN_USI_CL & 1 << PIN_USI_SCL)); // Verify that SCL becomes high.
+    DELAY_T4TWI;
+
+    /* Generate Start Condition */
+    PORT_USI &= ~(1 << PIN_USI_SDA);          // Force SDA LOW.
+    DELAY_T4TWI;
+    PORT_USI_CL &= ~(1 << PIN_USI_SCL);       // Pull SCL LOW.
+    PORT_USI |= 1 << PIN_USI_SDA;             // Release SDA.
+
+    if (!(USISR & 1 << USISIF)) return false;
+
+    write(addr << 1);
+    return true;
+  }
+
+  void UsiBuffered::stop() {
+    flush();
+
+    PORT_USI &= ~(1 << PIN_USI_SDA);          // Pull SDA low.
+    PORT_USI_CL |= 1 << PIN_USI_SCL;          // Release SCL.
+    while (!(PIN_USI_CL & 1 << PIN_USI_SCL)); // Wait for SCL to go high.
+    DELAY_T4TWI;
+    PORT_USI |= 1 << PIN_USI_SDA;             // Release SDA.
+    DELAY_T2TWI;
+  }
+
+}
+
+#endif
@@ -3,6 +3,19 @@
 
 #include "TinyI2CMaster.h"
 
+// Send the display data from a ring buffer with the USI hardware in the background,
+// the next bytes can be rendered while the current byte is on the bus (see UsiBuffered.cpp).
+// Takes timer 1 (SCL clock), timer 0 stays free for millis(), the timer jitter and the entropy.
+//#define WIREWRAP_USI_ISR
+// ATmega: stream the display data with the TWI hardware from a ring buffer (see AtmegaTwi.cpp)
+//#define WIREWRAP_ATMEGA_TWI
+// USI with the fastest bus speed the display accepts (probed once, cached in EEPROM, see TinyI2CMaster.cpp)
+//#define WIREWRAP_TINY_I2C
+
+#ifndef TINY_I2C_PROBE_ADDRESS
+#  define TINY_I2C_PROBE_ADDRESS 0x3C
+#endif
+
 #ifdef CORE_WIRE
 //#include <Wire.h>
 #endif
@@ -16,6 +29,7 @@ namespace wirerap {
   public:
     static void init() {
       i2c.init();
+      i2c.selectSpeed(TINY_I2C_PROBE_ADDRESS);
     }
 
     static bool start(uint8_t addr, int count=0) {
@@ -91,7 +105,43 @@ public:
   static void stop();
 };
 
+#ifdef WIREWRAP_USI_ISR
+
+// interrupt driven USI transmitter (write only), owns timer 1 and its compare A interrupt
+class UsiBuffered {
+public:
+  static void init();
+  static void write(uint8_t data);
+  static bool start(uint8_t addr);
+  static void stop();
+  static void flush();
+};
+
+class WireWrap : public UsiBuffered {};
+
+#elif defined(WIREWRAP_TINY_I2C)
+
+class WireWrap : public Tiny {};
+
+#elif defined(WIREWRAP_ATMEGA_TWI)
+
+// interrupt driven TWI transmitter (write only)
+class AtmegaTwi {
+public:
+  static void init();
+  static void write(uint8_t data);
+  static bool start(uint8_t addr);
+  static void stop();
+  static void flush();
+};
+
+class WireWrap : public AtmegaTwi {};
+
+#else
+
 class WireWrap : public BitBang {};
 
+#endif
+
 
 }
@@ -3,6 +3,11 @@
 #include "textUtils.h"
 #include "bitTables.h"
 #include "spritebank.h"
+#include "font3x5.h"
+#include "scratchBuffer.h"
+
+// the text is stored in the shared scratch buffer
+static uint8_t * const textBuffer = scratchBuffer;
 
 #undef TEXT_UTILS_SUPPRESS_LEADING_ZEROES
 
@@ -56,10 +61,60 @@ uint8_t displayText( uint8_t x, uint8_t y )
   return( 0x00 );
 }
 
+/*--------------------------------------------------------------*/
+// Displays the text buffer as 4 lines of 16 characters.
+// The 3x5 font is zoomed to 6x10 pixels (plus spacing) using 'nibbleZoom',
+// so every page shows either the upper or the lower half of a line.
+uint8_t displayZoomedText( uint8_t x, uint8_t y )
+{
+  // find appropriate character in text array (character width is 8 px)
+  uint8_t value = textBuffer[( x >> 3 ) + ( y >> 1 ) * ZOOMED_TEXT_COLUMNS];
+  // every font column is displayed twice, the last column is the gap
+  uint8_t column = ( x >> 1 ) & 0x03;
+
+  if ( ( value < FONT_3X5_FIRST_CHAR ) || ( value > FONT_3X5_LAST_CHAR ) || ( column >= FONT_3X5_WIDTH ) )
+  {
+    return( 0x00 );
+  }
+
+  uint8_t pixels = pgm_read_byte( font3x5 + ( value - FONT_3X5_FIRST_CHAR ) * FONT_3X5_WIDTH + column );
+  // the lower page shows the upper nibble
+  if ( y & 0x01 ) { pixels >>= 4; }
+
+  return( pgm_read_byte( nibbleZoom + ( pixels & 0x0f ) ) );
+}
+
+/*--------------------------------------------------------------*/
+// Prints a zero terminated PROGMEM string in zoomed mode.
+// Lines are separated by '\n' and centered horizontally.
+void pgm_printZoomedText( const char *text )
+{
+  uint8_t *line = textBuffer;
+
+  while ( true )
+  {
+    // determine the length of the line
+    uint8_t length = 0;
+    char value;
+    while ( ( ( value = pgm_read_byte( text + length ) ) != '\n' ) && ( value != 0 ) ) { length++; }
+
+    // center the line (longer lines are cut)
+    uint8_t visibleLength = ( length < ZOOMED_TEXT_COLUMNS ) ? length : ZOOMED_TEXT_COLUMNS;
+    memcpy_P( line + ( ( ZOOMED_TEXT_COLUMNS - visibleLength ) >> 1 ), text, visibleLength );
+
+    if ( value == 0 ) { return; }
+
+    // continue behind the separator
+    text += length + 1;
+    line += ZOOMED_TEXT_COLUMNS;
+    if ( line >= textBuffer + ZOOMED_TEXT_COLUMNS * ZOOMED_TEXT_LINES ) { return; }
+  }
+}
+
 /*--------------------------------------------------------------*/
 void clearTextBuffer()
 {
-  memset( textBuffer, 0x00, sizeof( textBuffer ) );
+  memset( textBuffer, 0x00, SCRATCH_BUFFER_SIZE );
 }
 
 /*--------------------------------------------------------------*/
@@ -74,7 +129,7 @@ void pgm_printText( uint8_t x, uint8_t *text, uint8_t textLength )
   memcpy_P( textBuffer + x, text, textLength );
 
 #if !(defined(__AVR_ATtiny85__) || defined(ARDUINO_AVR_ATTINYX4))
-  for ( auto n = 0; n < sizeof( textBuffer ); n++ )
+  for ( auto n = 0; n < SCRATCH_BUFFER_SIZE; n++ )
   {
     auto value = textBuffer[n];
     Serial.write( value == 0 ? '_' : value );
@@ -2,10 +2,13 @@
 
 #include <Arduino.h>
 
-// Video text memory:
+// Video text memory (located in the scratch buffer, owner SCRATCH_TEXT):
 // - one line (of 128 characters) in standard mode,
 // - four lines (of 16 characters) in zoomed mode
-static uint8_t textBuffer[128];
+
+// zoomed mode: every character is 8x16 pixels
+const uint8_t ZOOMED_TEXT_COLUMNS = 16;
+const uint8_t ZOOMED_TEXT_LINES = 4;
 
 void __attribute__ ((noinline)) convertValueToDigits( uint8_t value, uint8_t *digits );
 
@@ -15,4 +18,5 @@ uint8_t displayZoomedText( uint8_t x, uint8_t y );
 void __attribute__ ((noinline)) clearTextBuffer();
 void printText( uint8_t x, uint8_t *text, uint8_t textLength );
 void __attribute__ ((noinline)) pgm_printText( uint8_t x, uint8_t *text, uint8_t textLength );
+void pgm_printZoomedText( const char *text );
 uint8_t *getTextBuffer();
@@ -8,7 +8,44 @@
 //
 
 #include <Arduino.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include <util/atomic.h>
+#include <util/crc16.h>
 #include "tinyJoypadUtils.h"
+#include "tinyRandom.h"
+#include "profiler.h"
+#include "src/video/WireWrap.h"
+
+// the watchdog control register has different names
+#if defined(WDTCSR)
+  #define WATCHDOG_CONTROL WDTCSR
+#else
+  #define WATCHDOG_CONTROL WDTCR
+#endif
+
+// Power down stops all clocks (but the serial port needs its clock)
+#if defined(__AVR_ATtiny85__) || defined(ARDUINO_AVR_ATTINYX4)
+  #define FRAME_SLEEP_MODE SLEEP_MODE_PWR_DOWN
+#else
+  #define FRAME_SLEEP_MODE SLEEP_MODE_IDLE
+#endif
+
+#ifdef _ENABLE_PAGE_HASHES_
+// hashes of the pages on the display (the display is cleared by 'InitDisplay()',
+// an empty page has the hash 0)
+static uint16_t pageHash[8];
+// hash of the page which is currently rendered
+static uint16_t currentHash;
+// true while a page is rendered for calculating its hash only
+static bool hashPass = true;
+#endif
+
+// watchdog ticks (~16ms each) since 'InitFrameTimer()'
+static volatile uint8_t watchdogTicks = 0;
+// the tick at which the next frame starts
+static uint8_t nextFrameTick = 0;
 
 
 #if defined(ARDUINO_AVR_ATTINYX4)
@@ -20,13 +57,32 @@
   // include serial output functions
   #include "SerialHexTools.h"
 
+  #define SND_MASK 1 << PB4
+
+  #ifdef WIREWRAP_ATMEGA_TWI
+  // the display is driven by 'ssd1306xled' through WireWrap (Adafruit_SSD1306 would
+  // link Wire, which has its own TWI interrupt), the frame buffer is kept here
+  uint8_t displayBuffer[128 * 8];
+  #define getDisplayBuffer() displayBuffer
+  #else
   // include Adafruit library and immediately create an object
   #include <Adafruit_SSD1306.h>
 
-  #define SND_MASK 1 << PB4
+  const uint8_t DISPLAY_I2C_ADDRESS = 0x3C;
+  // the Wire buffer holds 32 bytes, one of them is the data control byte
+  const uint8_t DISPLAY_WIRE_CHUNK = 31;
 
-  Adafruit_SSD1306 display( 128, 64, &Wire, -1 );
+  // keep 400kHz after the library's transfers, the window updates below use Wire directly
+  Adafruit_SSD1306 display( 128, 64, &Wire, -1, 400000UL, 400000UL );
+  #define getDisplayBuffer() display.getBuffer()
+  #endif
   uint8_t *adafruitBuffer;
+  uint8_t adafruitColumn;
+  uint8_t adafruitPage;
+  // changed columns of every page since the last transfer (first > last means unchanged),
+  // the display RAM is undefined after 'begin()', so everything is sent the first time
+  uint8_t dirtyFirst[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  uint8_t dirtyLast[8] = { 127, 127, 127, 127, 127, 127, 127, 127 };
 #endif
 
 
@@ -125,6 +181,65 @@ bool isFlagPressed()
 
 #endif
 
+/*-------------------------------------------------------*/
+ISR( WDT_vect )
+{
+  watchdogTicks++;
+}
+
+/*-------------------------------------------------------*/
+// Starts the watchdog in interrupt mode (~16ms), it wakes the MCU for every tick.
+void InitFrameTimer()
+{
+  ATOMIC_BLOCK( ATOMIC_RESTORESTATE )
+  {
+    wdt_reset();
+    WATCHDOG_CONTROL = ( 1 << WDCE ) | ( 1 << WDE );
+    WATCHDOG_CONTROL = ( 1 << WDIE ) | ( 1 << WDIF );
+    nextFrameTick = watchdogTicks + FRAME_TICKS;
+  }
+}
+
+/*-------------------------------------------------------*/
+// Sleeps until the next frame starts. A frame which took too long
+// restarts the schedule instead of rushing the following frames.
+void waitForNextFrame()
+{
+  PROFILE_END( PROFILE_FRAME );
+
+  cli();
+  while ( int8_t( nextFrameTick - watchdogTicks ) > 0 )
+  {
+    // a background EEPROM write needs its interrupt, which can't wake the MCU from power down
+    set_sleep_mode( ( EECR & ( 1 << EERIE ) ) ? SLEEP_MODE_IDLE : FRAME_SLEEP_MODE );
+    sleep_enable();
+    // 'sei' guarantees that 'sleep' is executed before any interrupt
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    cli();
+  }
+
+  if ( int8_t( watchdogTicks - nextFrameTick ) > 0 )
+  {
+    // frame overrun, start a new schedule
+    nextFrameTick = watchdogTicks + FRAME_TICKS;
+  }
+  else
+  {
+    nextFrameTick += FRAME_TICKS;
+  }
+  sei();
+
+  PROFILE_BEGIN( PROFILE_FRAME );
+}
+
+/*-------------------------------------------------------*/
+void waitFrames( uint8_t frames )
+{
+  while ( frames-- != 0 ) { waitForNextFrame(); }
+}
+
 /*-------------------------------------------------------*/
 // wait until all buttons are released
 void waitUntilButtonsReleased()
@@ -137,7 +252,7 @@ void waitUntilButtonsReleased()
 void waitUntilButtonsReleased( const uint8_t delay )
 {
   waitUntilButtonsReleased();
-  _delay_ms( delay );
+  waitFrames( delay / FRAME_TIME_MS );
 }
 
 /*-------------------------------------------------------*/
@@ -149,6 +264,50 @@ void _variableDelay_us( uint8_t delayValue )
   }
 }
 
+/*-------------------------------------------------------*/
+// Collects a random seed from the jitter between the watchdog's RC oscillator
+// and the CPU clock (and from the ADC noise). Takes about 128ms.
+uint16_t getHardwareEntropy()
+{
+  uint16_t entropy = 0;
+
+  // timer 0 is the reference clock, make sure it's running
+  if ( ( TCCR0B & 0x07 ) == 0 ) { TCCR0B |= ( 1 << CS00 ); }
+
+  // the watchdog interrupt flag is polled, so no interrupt may occur
+  ATOMIC_BLOCK( ATOMIC_RESTORESTATE )
+  {
+    for ( uint8_t n = 0; n < 8; n++ )
+    {
+      // start the watchdog in interrupt mode with a timeout of ~16ms
+      wdt_reset();
+      WATCHDOG_CONTROL = ( 1 << WDCE ) | ( 1 << WDE );
+      WATCHDOG_CONTROL = ( 1 << WDIE ) | ( 1 << WDIF );
+      // wait for the timeout
+      while ( !( WATCHDOG_CONTROL & ( 1 << WDIF ) ) );
+
+      entropy = xorshift16( entropy ^ TCNT0 );
+    #ifdef LEFT_RIGHT_BUTTON
+      entropy ^= analogRead( LEFT_RIGHT_BUTTON ) & 0x03;
+    #endif
+    }
+
+    // stop the watchdog
+    WATCHDOG_CONTROL = ( 1 << WDCE ) | ( 1 << WDE ) | ( 1 << WDIF );
+    WATCHDOG_CONTROL = 0x00;
+  }
+
+  return( entropy );
+}
+
+/*-------------------------------------------------------*/
+// The time of a button press depends on the player's timing
+// (timer 0 alone isn't enough, it stops while sleeping)
+uint8_t getTimerJitter()
+{
+  return( TCNT0 ^ watchdogTicks );
+}
+
 /*-------------------------------------------------------*/
 // This code was originaly borrowed from Daniel C's Tiny-invaders :)
 // Code optimization by sbr
@@ -166,12 +325,12 @@ void Sound( const uint8_t freq, const uint8_t dur )
 /*-------------------------------------------------------*/
 void InitDisplay()
 {
-#if defined(__AVR_ATtiny85__) || defined(ARDUINO_AVR_ATTINYX4) /* codepath for ATtiny85 */
+#if defined(__AVR_ATtiny85__) || defined(ARDUINO_AVR_ATTINYX4) || defined(WIREWRAP_ATMEGA_TWI) /* codepath for ATtiny85 */
   SSD1306.ssd1306_init();
 #else
   // SSD1306_SWITCHCAPVCC = generate display voltage from 3.3V internally
   // Address 0x3D for 128x64
-  if( !display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) 
+  if( !display.begin(SSD1306_SWITCHCAPVCC, DISPLAY_I2C_ADDRESS)) 
   { 
     Serial.println(F("SSD1306 allocation failed")); for(;;);
   }
@@ -182,38 +341,63 @@ void InitDisplay()
 // This code will init the display for row <y>
 void TinyFlip_PrepareDisplayRow( uint8_t y )
 {
+#ifdef _ENABLE_PAGE_HASHES_
+  if ( hashPass )
+  {
+    currentHash = 0;
+    return;
+  }
+#endif
+
 #if defined(__AVR_ATtiny85__)||defined(ARDUINO_AVR_ATTINYX4)  /* codepath for ATtiny85 */
-    // initialize image transfer to segment 'y'
-    SSD1306.ssd1306_send_command(0xb0 + y);
+    // initialize image transfer to segment 'y' (one command transfer, because
+    // every start/stop has to wait until the buffered bytes are on the bus)
   #ifdef _USE_SH1106_
     // SH1106 internally uses 132 pixels/line,
     // output is (always?) centered, so we need to start at position 2
-    SSD1306.ssd1306_send_command(0x02);
-    SSD1306.ssd1306_send_command(0x10);  
+    SSD1306.ssd1306_setpos( 2, y );
   #else
     // classic SSD1306 supports only 128 pixels/line, so we start at 0
-    SSD1306.ssd1306_send_command(0x00);
-    SSD1306.ssd1306_send_command(0x10);  
+    SSD1306.ssd1306_setpos( 0, y );
   #endif    
     SSD1306.ssd1306_send_data_start();
 
 #else  /* codepath for any Adafruit_SSD1306 supported MCU */
 
   // address the display buffer
-  adafruitBuffer = display.getBuffer() + ( y * 128 );
+  adafruitBuffer = getDisplayBuffer() + ( y * 128 );
+  adafruitColumn = 0;
+  adafruitPage = y;
 #endif
 }
 
 /*-------------------------------------------------------*/
 void TinyFlip_SendPixels( uint8_t pixels )
 {
+#ifdef _ENABLE_PAGE_HASHES_
+  if ( hashPass )
+  {
+    // a simple checksum isn't enough, moving a pattern (like the selection marker)
+    // often keeps the sum, CRC16 detects that (and it's used by GameStorage anyway)
+    currentHash = _crc_ccitt_update( currentHash, pixels );
+    return;
+  }
+#endif
+
 #if defined(__AVR_ATtiny85__)||defined(ARDUINO_AVR_ATTINYX4) /* codepath for ATtiny85 */
   // send a byte directly to the SSD1306
   SSD1306.ssd1306_send_byte( pixels );
 
 #else  /* codepath for any Adafruit_SSD1306 supported MCU */
-  // write pixels directly to the buffer
-  *adafruitBuffer++ = pixels;
+  // write pixels directly to the buffer and remember which columns changed
+  if ( *adafruitBuffer != pixels )
+  {
+    *adafruitBuffer = pixels;
+    if ( adafruitColumn < dirtyFirst[adafruitPage] ) { dirtyFirst[adafruitPage] = adafruitColumn; }
+    if ( adafruitColumn > dirtyLast[adafruitPage] ) { dirtyLast[adafruitPage] = adafruitColumn; }
+  }
+  adafruitBuffer++;
+  adafruitColumn++;
 #endif
 }
 
@@ -221,6 +405,10 @@ void TinyFlip_SendPixels( uint8_t pixels )
 // This code will finish a row (only on Tiny85)
 void TinyFlip_FinishDisplayRow()
 {
+#ifdef _ENABLE_PAGE_HASHES_
+  if ( hashPass ) { return; }
+#endif
+
 #if defined(__AVR_ATtiny85__)||defined(ARDUINO_AVR_ATTINYX4)
   // this line appears to be optional, as it was never called during the intro screen...
   // but hey, we still have some bytes left ;)
@@ -228,17 +416,86 @@ void TinyFlip_FinishDisplayRow()
 #endif
 }
 
+/*-------------------------------------------------------*/
+// Called after a page was rendered. Returns true if the page has to be rendered
+// again, because the hash pass found a change (the second pass sends it).
+bool TinyFlip_PageChanged( uint8_t y )
+{
+#ifdef _ENABLE_PAGE_HASHES_
+  if ( hashPass )
+  {
+    if ( currentHash != pageHash[y] )
+    {
+      pageHash[y] = currentHash;
+      hashPass = false;
+      return( true );
+    }
+  }
+  else
+  {
+    // the page was sent, the next one starts with the hash pass
+    hashPass = true;
+  }
+#endif
+  return( false );
+}
+
 /*-------------------------------------------------------*/
 void TinyFlip_DisplayBuffer()
 {
 #if !(defined(__AVR_ATtiny85__)||defined(ARDUINO_AVR_ATTINYX4)) /* codepath for any Adafruit_SSD1306 supported MCU */
-  // display buffer (not necessary)
-  display.display();
+  // 'display.display()' would send the full 1KB buffer, only send the changed window of every page
+  PROFILE_BEGIN( PROFILE_DISPLAY );
+  uint8_t *buffer = getDisplayBuffer();
+  for ( uint8_t page = 0; page < 8; page++, buffer += 128 )
+  {
+    uint8_t first = dirtyFirst[page];
+    uint8_t last = dirtyLast[page];
+    if ( first > last ) { continue; }
+
+    // horizontal addressing mode, so the data wraps inside the window
+  #ifdef WIREWRAP_ATMEGA_TWI
+    // page address (0x22) and column address (0x21), then the window as one continuous transfer
+    SSD1306.ssd1306_send_command( 0x22 );
+    SSD1306.ssd1306_send_command( page );
+    SSD1306.ssd1306_send_command( page );
+    SSD1306.ssd1306_send_command( 0x21 );
+    SSD1306.ssd1306_send_command( first );
+    SSD1306.ssd1306_send_command( last );
+
+    SSD1306.ssd1306_send_data_start();
+    for ( uint8_t x = first; x <= last; x++ ) { SSD1306.ssd1306_send_byte( buffer[x] ); }
+    SSD1306.ssd1306_send_data_stop();
+  #else
+    display.ssd1306_command( SSD1306_PAGEADDR );
+    display.ssd1306_command( page );
+    display.ssd1306_command( page );
+    display.ssd1306_command( SSD1306_COLUMNADDR );
+    display.ssd1306_command( first );
+    display.ssd1306_command( last );
+
+    for ( uint8_t x = first; x <= last; )
+    {
+      Wire.beginTransmission( DISPLAY_I2C_ADDRESS );
+      Wire.write( 0x40 );
+      for ( uint8_t n = 0; ( n < DISPLAY_WIRE_CHUNK ) && ( x <= last ); n++, x++ ) { Wire.write( buffer[x] ); }
+      Wire.endTransmission();
+    }
+  #endif
+
+    dirtyFirst[page] = 127;
+    dirtyLast[page] = 0;
+  }
+  PROFILE_END( PROFILE_DISPLAY );
 #endif
 }
 
 /*-------------------------------------------------------*/
-// Outputs the screen as one hex byte per pixel. To get an actual image perform the following steps:
+// Outputs the screen as a binary frame (RLE compressed, ~100 bytes for a typical screen).
+// Run 'tools/serial_receiver.py /dev/ttyACM0' to get PNG files.
+//
+// Without SERIAL_BINARY_FRAMES the screen is printed as one hex byte per pixel.
+// To get an actual image perform the following steps:
 // (1) The output can be converted to binary with 'https://tomeko.net/online_tools/hex_to_file.php?lang=en' online.
 // (2) Then import the file with IrfanView (https://www.irfanview.com/): Open as -> RAW file...
 // (3) Set Image width to 64 and Image height to 128, 8 BPP -> OK
@@ -246,9 +503,14 @@ void TinyFlip_DisplayBuffer()
 void TinyFlip_SerialScreenshot()
 {
 #if !(defined(__AVR_ATtiny85__)||defined(ARDUINO_AVR_ATTINYX4)) /* codepath for any Adafruit_SSD1306 supported MCU */
+  #ifdef SERIAL_BINARY_FRAMES
+  // send the full buffer as a compressed binary frame
+  serialSendScreenBuffer( getDisplayBuffer(), 128, 8 );
+  #else
   // print a short header
   Serial.println(F("\r\nTinyMinez screenshot"));
   // output the full buffer as a hexdump to the serial port
-  printScreenBufferToSerial( display.getBuffer(), 128, 8 );
+  printScreenBufferToSerial( getDisplayBuffer(), 128, 8 );
+  #endif
 #endif
 }
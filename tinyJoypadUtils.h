@@ -26,15 +26,34 @@ bool isDownPressed();
 bool isFirePressed();
 bool isFlagPressed();
 
+// frame timing (driven by the watchdog interrupt, the MCU sleeps in between)
+const uint8_t WATCHDOG_TICK_MS = 16;
+const uint8_t FRAME_TICKS      = 3;
+const uint8_t FRAME_TIME_MS    = WATCHDOG_TICK_MS * FRAME_TICKS;
+
+void InitFrameTimer();
+void waitForNextFrame();
+void waitFrames( uint8_t frames );
+
 void waitUntilButtonsReleased();
 void waitUntilButtonsReleased( const uint8_t delay );
 void _variableDelay_us( uint8_t delayValue );
+uint16_t getHardwareEntropy();
+uint8_t getTimerJitter();
 void Sound( const uint8_t freq, const uint8_t dur );
 
+// Render every display page twice: the first pass only calculates a 16 bit hash,
+// the page is transmitted only if the hash differs from the page on the display.
+// Costs 16 bytes of RAM, saves the I2C transfer of all unchanged pages.
+#if defined(__AVR_ATtiny85__) || defined(ARDUINO_AVR_ATTINYX4)
+  #define _ENABLE_PAGE_HASHES_
+#endif
+
 // functions to simplify display handling between ATtiny85 and Ardafruit_SSD1306
 void InitDisplay();
 void TinyFlip_PrepareDisplayRow( uint8_t y );
 void TinyFlip_SendPixels( uint8_t pixels );
 void TinyFlip_FinishDisplayRow();
+bool TinyFlip_PageChanged( uint8_t y );
 void TinyFlip_DisplayBuffer();
 void TinyFlip_SerialScreenshot();
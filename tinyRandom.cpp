@@ -0,0 +1,54 @@
+#include <Arduino.h>
+#include "tinyRandom.h"
+
+// generator state (must never be 0)
+static uint16_t randomState = 1;
+
+/*--------------------------------------------------------------*/
+// One xorshift16 step (shifts 7, 9, 8, full period of 65535).
+// Zero would be a fixed point, so it is replaced by a constant.
+uint16_t xorshift16( uint16_t value )
+{
+  if ( value == 0 ) { value = 0xace1; }
+
+  value ^= value << 7;
+  value ^= value >> 9;
+  value ^= value << 8;
+
+  return( value );
+}
+
+/*--------------------------------------------------------------*/
+// The seed is stored as 32 bits (EEPROM, replays), both halves count.
+void tinyRandomSeed( uint32_t seed )
+{
+  randomState = xorshift16( uint16_t( seed ) ^ uint16_t( seed >> 16 ) );
+}
+
+/*--------------------------------------------------------------*/
+// returns the highest byte, which is the best mixed one
+uint8_t tinyRandomByte()
+{
+  randomState = xorshift16( randomState );
+  return( uint8_t( randomState >> 8 ) );
+}
+
+/*--------------------------------------------------------------*/
+// Returns an evenly distributed value in 0..limit-1 (limit must not be 0).
+// Values are masked to the next power of two and rejected if too large,
+// which avoids the bias of a modulo and the division itself.
+uint8_t tinyRandomBelow( const uint8_t limit )
+{
+  uint8_t mask = limit - 1;
+  mask |= mask >> 1;
+  mask |= mask >> 2;
+  mask |= mask >> 4;
+
+  uint8_t value;
+  do
+  {
+    value = tinyRandomByte() & mask;
+  } while ( value >= limit );
+
+  return( value );
+}
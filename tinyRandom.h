@@ -0,0 +1,14 @@
+#pragma once
+
+#include <Arduino.h>
+
+// A small xorshift16 pseudo random number generator.
+// Much faster and smaller than Arduino's 'random()', which needs 32 bit
+// divisions - painful on a MCU without even a hardware multiplier.
+// 16 bits are enough: a level takes at most a few hundred steps of the
+// period of 65535, and the 8 bit AVR shifts only two registers per step.
+
+uint16_t xorshift16( uint16_t value );
+void     tinyRandomSeed( uint32_t seed );
+uint8_t  tinyRandomByte();
+uint8_t  tinyRandomBelow( const uint8_t limit );
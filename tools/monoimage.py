@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+#
+# Small helpers for 1 bit images used by the TinyMinez host tools.
+#
+# A frame is stored the same way as the SSD1306 GDDRAM: a list of 'pages'
+# (rows of 8 pixels), each page holding one byte per column with the
+# LSB being the topmost pixel.
+#
+# Only the Python standard library is used, so the tools run on any Linux
+# box without installing additional packages.
+#
+
+import struct
+import zlib
+
+
+class MonoFrame:
+    """A 1 bit frame in SSD1306 page layout."""
+
+    def __init__(self, width=128, height=64, data=None):
+        self.width = width
+        self.height = height
+        self.pages = height // 8
+        if data is None:
+            data = bytes(width * self.pages)
+        if len(data) != width * self.pages:
+            raise ValueError("frame data has %d bytes, expected %d" % (len(data), width * self.pages))
+        self.data = bytearray(data)
+
+    def copy(self):
+        return MonoFrame(self.width, self.height, self.data)
+
+    def pixel(self, x, y):
+        return (self.data[(y >> 3) * self.width + x] >> (y & 0x07)) & 0x01
+
+    def rows(self):
+        """Yields every pixel row as a list of 0/1 values (1 = lit)."""
+        for y in range(self.height):
+            yield [self.pixel(x, y) for x in range(self.width)]
+
+    def inverted(self):
+        return MonoFrame(self.width, self.height, bytes(b ^ 0xff for b in self.data))
+
+    def mirrored(self, horizontal, vertical):
+        """Returns the frame as seen with segment remap/COM scan direction applied."""
+        frame = MonoFrame(self.width, self.height)
+        for y in range(self.height):
+            for x in range(self.width):
+                if self.pixel(x, y):
+                    dx = self.width - 1 - x if horizontal else x
+                    dy = self.height - 1 - y if vertical else y
+                    frame.data[(dy >> 3) * self.width + dx] |= 1 << (dy & 0x07)
+        return frame
+
+    def diff(self, other):
+        """Returns a list of (x, y) positions where both frames differ."""
+        if (self.width, self.height) != (other.width, other.height):
+            raise ValueError("frame sizes differ")
+        changes = []
+        for n, (a, b) in enumerate(zip(self.data, other.data)):
+            delta = a ^ b
+            if delta:
+                x = n % self.width
+                page = n // self.width
+                for bit in range(8):
+                    if delta & (1 << bit):
+                        changes.append((x, page * 8 + bit))
+        return changes
+
+    def __eq__(self, other):
+        return isinstance(other, MonoFrame) and (self.width, self.height, self.data) == (other.width, other.height, other.data)
+
+
+#--------------------------------------------------------------
+# PBM (P4) - trivial to write, read and compare, used for golden images.
+# Lit pixels are stored as '1' bits, so PBM viewers show them black.
+def write_pbm(path, frame):
+    with open(path, "wb") as f:
+        f.write(b"P4\n%d %d\n" % (frame.width, frame.height))
+        for row in frame.rows():
+            f.write(_pack_row(row))
+
+
+def read_pbm(path):
+    with open(path, "rb") as f:
+        content = f.read()
+    tokens = []
+    pos = 0
+    # parse magic, width and height (comments are allowed in the header)
+    while len(tokens) < 3:
+        while content[pos:pos + 1].isspace():
+            pos += 1
+        if content[pos:pos + 1] == b"#":
+            pos = content.index(b"\n", pos)
+            continue
+        start = pos
+        while not content[pos:pos + 1].isspace():
+            pos += 1
+        tokens.append(content[start:pos])
+    # exactly one whitespace character separates header and raster
+    pos += 1
+    if tokens[0] != b"P4":
+        raise ValueError("%s: only binary PBM (P4) is supported" % path)
+    width, height = int(tokens[1]), int(tokens[2])
+    stride = (width + 7) // 8
+    frame = MonoFrame(width, height)
+    for y in range(height):
+        row = content[pos + y * stride:pos + (y + 1) * stride]
+        for x in range(width):
+            if row[x >> 3] & (0x80 >> (x & 0x07)):
+                frame.data[(y >> 3) * width + x] |= 1 << (y & 0x07)
+    return frame
+
+
+#--------------------------------------------------------------
+# PNG (1 bit grayscale) - for looking at the results
+def write_png(path, frame, scale=1):
+    raw = bytearray()
+    for row in frame.rows():
+        # lit pixels are white, like on the OLED
+        row = [pixel for pixel in row for _ in range(scale)]
+        packed = _pack_row(row)
+        for _ in range(scale):
+            # filter type 0 (none)
+            raw.append(0)
+            raw += packed
+
+    def chunk(tag, payload):
+        return (struct.pack(">I", len(payload)) + tag + payload
+                + struct.pack(">I", zlib.crc32(tag + payload) & 0xffffffff))
+
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", frame.width * scale, frame.height * scale, 1, 0, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(bytes(raw), 9)))
+        f.write(chunk(b"IEND", b""))
+
+
+def write_image(path, frame, scale=1):
+    """Writes PNG or PBM depending on the file extension."""
+    if path.lower().endswith(".pbm"):
+        write_pbm(path, frame)
+    else:
+        write_png(path, frame, scale)
+
+
+def frame_from_8bpp_dump(values, width=128, height=64):
+    """Converts the column wise 8 bpp output of 'printScreenBufferToSerial()'."""
+    frame = MonoFrame(width, height)
+    for n, value in enumerate(values):
+        if value:
+            x, y = divmod(n, height)
+            frame.data[(y >> 3) * width + x] |= 1 << (y & 0x07)
+    return frame
+
+
+def _pack_row(row):
+    """Packs a row of 0/1 values MSB first."""
+    packed = bytearray((len(row) + 7) // 8)
+    for x, pixel in enumerate(row):
+        if pixel:
+            packed[x >> 3] |= 0x80 >> (x & 0x07)
+    return bytes(packed)
@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+#
+# Receiver for the binary frames sent by SerialHexTools.cpp (SERIAL_BINARY_FRAMES).
+#
+# Frame layout:  A5 5A type lengthLo lengthHi payload[length] crcLo crcHi
+# The CRC (CRC-16/CCITT-FALSE) covers type, length and payload.
+#
+#   'S' screenshot : width, heightInBytes, RLE compressed screen buffer -> PNG
+#   'L' level      : status, width, height, mines, flags, hidden, clicks (16 bit),
+#                    seed (32 bit), RLE compressed level data            -> board view
+#   'G' game status: status
+#
+# Everything between frames (debug text from Serial.print()) is passed through.
+#
+# Usage:
+#   serial_receiver.py /dev/ttyACM0 [-b 115200] [-o screenshots/]
+#   serial_receiver.py capture.bin               (replay a recorded stream)
+#
+
+import argparse
+import os
+import struct
+import sys
+import termios
+
+from monoimage import MonoFrame, write_image
+
+SYNC = b"\xa5\x5a"
+
+STATUS_NAMES = ["intro", "rules", "difficultySelection", "prepareGame",
+                "playGame", "boom", "gameOver", "gameWon"]
+
+# cell bits (see TinyMinezGame.h)
+COUNT_MASK = 0x0f
+BOMB = 0x10
+FLAG = 0x20
+HIDDEN = 0x40
+CURSOR = 0x80
+
+BAUD_RATES = {9600: termios.B9600, 19200: termios.B19200, 38400: termios.B38400,
+              57600: termios.B57600, 115200: termios.B115200, 230400: termios.B230400}
+
+
+def crc16(data, crc=0xffff):
+    for value in data:
+        crc ^= value << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xffff
+    return crc
+
+
+def rle_decompress(data, size):
+    """Python version of pgm_RLEdecompress() from RLEdecompression.cpp."""
+    output = bytearray()
+    pos = 0
+    while len(output) < size:
+        count = data[pos]
+        pos += 1
+        if count & 0x80:
+            if count & 0x40:
+                value = 0xff
+            elif count & 0x20:
+                value = 0x00
+            else:
+                value = data[pos]
+                pos += 1
+            output += bytes([value]) * ((count & 0x1f) + 1)
+        else:
+            output += data[pos:pos + count + 1]
+            pos += count + 1
+    return bytes(output[:size])
+
+
+#--------------------------------------------------------------
+def open_port(path, baud):
+    """Opens a serial port in raw mode (or a plain file for replaying captures)."""
+    fd = os.open(path, os.O_RDONLY | os.O_NOCTTY)
+    if os.isatty(fd):
+        attributes = termios.tcgetattr(fd)
+        # iflag, oflag, cflag, lflag, ispeed, ospeed, cc
+        attributes[0] = 0
+        attributes[1] = 0
+        attributes[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attributes[3] = 0
+        attributes[4] = attributes[5] = BAUD_RATES[baud]
+        attributes[6][termios.VMIN] = 1
+        attributes[6][termios.VTIME] = 0
+        termios.tcsetattr(fd, termios.TCSANOW, attributes)
+    return os.fdopen(fd, "rb", buffering=0)
+
+
+def read_stream(stream):
+    """Yields ('text', bytes) and ('frame', type, payload) items."""
+    buffer = bytearray()
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            if buffer:
+                yield ("text", bytes(buffer))
+            return
+        buffer += chunk
+        while True:
+            start = buffer.find(SYNC)
+            if start < 0:
+                # keep a possible partial sync byte
+                keep = 1 if buffer.endswith(SYNC[:1]) else 0
+                if len(buffer) > keep:
+                    yield ("text", bytes(buffer[:len(buffer) - keep]))
+                    del buffer[:len(buffer) - keep]
+                break
+            if start > 0:
+                yield ("text", bytes(buffer[:start]))
+                del buffer[:start]
+            if len(buffer) < 5:
+                break
+            frame_type = buffer[2]
+            length = buffer[3] | (buffer[4] << 8)
+            if len(buffer) < 7 + length:
+                break
+            payload = bytes(buffer[5:5 + length])
+            crc = buffer[5 + length] | (buffer[6 + length] << 8)
+            if crc16(buffer[2:5 + length]) == crc:
+                yield ("frame", chr(frame_type), payload)
+                del buffer[:7 + length]
+            else:
+                # false sync (or a damaged frame) - treat the sync bytes as text
+                yield ("text", bytes(buffer[:2]))
+                del buffer[:2]
+
+
+#--------------------------------------------------------------
+def status_name(value):
+    return STATUS_NAMES[value] if value < len(STATUS_NAMES) else "<unknown status %d>" % value
+
+
+def cell_symbol(value, reveal):
+    if (value & HIDDEN) and not reveal:
+        return "F" if value & FLAG else "#"
+    if value & BOMB:
+        return "*"
+    count = value & COUNT_MASK
+    return str(count) if count else "."
+
+
+def print_board(width, height, cells, reveal):
+    for y in range(height):
+        row = ""
+        for x in range(width):
+            value = cells[x + y * width]
+            symbol = cell_symbol(value, reveal)
+            row += ("[%s]" if value & CURSOR else " %s ") % symbol
+        print(row)
+
+
+def handle_frame(frame_type, payload, args, counters):
+    if frame_type == "S":
+        width, height_in_bytes = payload[0], payload[1]
+        data = rle_decompress(payload[2:], width * height_in_bytes)
+        frame = MonoFrame(width, height_in_bytes * 8, data)
+        path = os.path.join(args.output, "screenshot_%04d.png" % counters["S"])
+        write_image(path, frame, args.scale)
+        print("[screenshot] %s (%d bytes on the wire)" % (path, len(payload) + 7))
+    elif frame_type == "L":
+        (status, width, height, mines, flags, hidden, clicks, seed) = struct.unpack("<6BHL", payload[:12])
+        cells = rle_decompress(payload[12:], width * height)
+        print("[level] status = %s, mines = %d, markedMines = %d, hiddenTiles = %d, clicksCount = %d, seed = %d"
+              % (status_name(status), mines, flags, hidden, clicks, seed))
+        print_board(width, height, cells, args.reveal)
+    elif frame_type == "G":
+        print("[status] %s" % status_name(payload[0]))
+    else:
+        print("[unknown frame '%s', %d bytes]" % (frame_type, len(payload)))
+    counters[frame_type] = counters.get(frame_type, 0) + 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode TinyMinez binary serial frames.")
+    parser.add_argument("port", help="serial device or recorded stream")
+    parser.add_argument("-b", "--baud", type=int, default=115200, choices=sorted(BAUD_RATES))
+    parser.add_argument("-o", "--output", default=".", help="directory for screenshots")
+    parser.add_argument("-s", "--scale", type=int, default=4, help="PNG zoom factor")
+    parser.add_argument("-r", "--reveal", action="store_true", help="show hidden cells in board views")
+    args = parser.parse_args()
+
+    os.makedirs(args.output, exist_ok=True)
+    counters = {"S": 0}
+    try:
+        with open_port(args.port, args.baud) as stream:
+            for item in read_stream(stream):
+                if item[0] == "text":
+                    sys.stdout.write(item[1].decode("latin-1"))
+                else:
+                    handle_frame(item[1], item[2], args, counters)
+                sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+#
+# Flash/RAM budget report for the ATtiny85 build.
+#
+# Builds the sketch with the settings from ATTinyCore_settings_for_ATtiny85.png
+# (16 MHz PLL, LTO enabled, millis()/micros() disabled) using arduino-cli, then
+# splits 'avr-size' and 'avr-nm' output into a per module and per symbol table.
+# The exit code is 1 if flash or RAM exceed the budget, so a size regression
+# fails like a broken build.
+#
+# Usage:
+#   size_report.py --build                      (compile, then report)
+#   size_report.py --elf build/TinyMinez.ino.elf
+#   size_report.py --build --flash-budget 8000 --stack-reserve 240 --top 40
+#
+# Requires arduino-cli with ATTinyCore installed (for --build) and the avr-gcc
+# binutils in the PATH (they are part of the Arduino AVR toolchain).
+#
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# the documented IDE settings (see ATTinyCore_settings_for_ATtiny85.png)
+DEFAULT_FQBN = ("ATTinyCore:avr:attinyx5:chip=85,clock=16pll,eesave=aenable,"
+                "bod=disable,LTO=enable,millis=disabled")
+
+FLASH_SIZE = 8192
+RAM_SIZE = 512
+
+# modules for symbols without debug line information
+SYMBOL_MODULES = [
+    (re.compile(r"^BasicGame<|^LevelSize<"), "TinyMinesGame.cpp"),
+    (re.compile(r"^Selection::"), "Selection.cpp"),
+    (re.compile(r"^Replay::|^replay$"), "Replay.cpp"),
+    (re.compile(r"^GameStorage::|^gameStorage$"), "GameStorage.cpp"),
+    (re.compile(r"SSD1306|ssd1306|i2c|I2C|USI", re.I), "src/video (I2C + SSD1306)"),
+    (re.compile(r"^__vector_|^__vectors$"), "(interrupt vectors)"),
+    (re.compile(r"^__|^_GLOBAL_"), "(runtime library)"),
+]
+
+# avr-nm symbol types
+FLASH_TYPES = set("tTrRvVwW")
+DATA_TYPES = set("dD")
+BSS_TYPES = set("bB")
+
+
+def run(command):
+    try:
+        return subprocess.run(command, check=True, stdout=subprocess.PIPE,
+                              universal_newlines=True).stdout
+    except FileNotFoundError:
+        raise SystemExit("%s not found - is the toolchain in the PATH?" % command[0])
+    except subprocess.CalledProcessError as error:
+        raise SystemExit("'%s' failed with exit code %d" % (" ".join(command), error.returncode))
+
+
+#--------------------------------------------------------------
+def build(sketch, fqbn, build_path):
+    run(["arduino-cli", "compile", "--fqbn", fqbn, "--build-path", build_path, sketch])
+    sketch_file = [name for name in os.listdir(sketch) if name.endswith(".ino")][0]
+    return os.path.join(build_path, sketch_file + ".elf")
+
+
+def section_sizes(elf):
+    """Returns {section: size} from 'avr-size -A'."""
+    sizes = {}
+    for line in run(["avr-size", "-A", elf]).splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0].startswith(".") and fields[1].isdigit():
+            sizes[fields[0]] = int(fields[1])
+    return sizes
+
+
+def symbols(elf):
+    """Yields (name, size, type, module) from 'avr-nm --size-sort'."""
+    output = run(["avr-nm", "--size-sort", "--print-size", "--demangle", "--line-numbers", elf])
+    for line in output.splitlines():
+        location = None
+        if "\t" in line:
+            line, location = line.split("\t", 1)
+        fields = line.split(None, 3)
+        if len(fields) < 4:
+            continue
+        _, size, symbol_type, name = fields
+        yield name, int(size, 16), symbol_type, module_of(name, location)
+
+
+def module_of(name, location):
+    if location:
+        path = location.rsplit(":", 1)[0]
+        # keep the library folder for the display driver, the rest is flat
+        parts = path.replace("\\", "/").split("/")
+        return "/".join(parts[-3:]) if "src" in parts[-3:-1] else parts[-1]
+    for pattern, module in SYMBOL_MODULES:
+        if pattern.search(name):
+            return module
+    return "(unknown)"
+
+
+#--------------------------------------------------------------
+def report(elf, args):
+    sizes = section_sizes(elf)
+    flash = sizes.get(".text", 0) + sizes.get(".data", 0)
+    ram = sizes.get(".data", 0) + sizes.get(".bss", 0) + sizes.get(".noinit", 0)
+
+    modules = {}
+    table = []
+    for name, size, symbol_type, module in symbols(elf):
+        flash_bytes = size if symbol_type in FLASH_TYPES | DATA_TYPES else 0
+        ram_bytes = size if symbol_type in DATA_TYPES | BSS_TYPES else 0
+        if not (flash_bytes or ram_bytes):
+            continue
+        entry = modules.setdefault(module, [0, 0])
+        entry[0] += flash_bytes
+        entry[1] += ram_bytes
+        table.append((flash_bytes, ram_bytes, name, module))
+
+    print("%-40s %8s %6s" % ("module", "flash", "RAM"))
+    for module, (flash_bytes, ram_bytes) in sorted(modules.items(), key=lambda item: -item[1][0]):
+        print("%-40s %8d %6d" % (module, flash_bytes, ram_bytes))
+
+    print()
+    print("%-40s %8s %6s  %s" % ("symbol", "flash", "RAM", "module"))
+    for flash_bytes, ram_bytes, name, module in sorted(table, key=lambda entry: (-entry[0], -entry[1]))[:args.top]:
+        print("%-40s %8d %6d  %s" % (name[:40], flash_bytes, ram_bytes, module))
+
+    # the stack lives in the RAM left over by the static variables
+    ram_budget = args.ram_budget - args.stack_reserve
+    print()
+    print("flash : %5d bytes used, %5d bytes left (budget %d)" % (flash, args.flash_budget - flash, args.flash_budget))
+    print("RAM   : %5d bytes used, %5d bytes left (budget %d = %d - %d stack reserve)"
+          % (ram, ram_budget - ram, ram_budget, args.ram_budget, args.stack_reserve))
+
+    failed = False
+    if flash > args.flash_budget:
+        print("*** flash budget exceeded by %d bytes ***" % (flash - args.flash_budget))
+        failed = True
+    if ram > ram_budget:
+        print("*** RAM budget exceeded by %d bytes ***" % (ram - ram_budget))
+        failed = True
+    return 1 if failed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flash/RAM budget report for TinyMinez.")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--build", action="store_true", help="compile the sketch with arduino-cli first")
+    source.add_argument("--elf", help="report an existing ELF file")
+    parser.add_argument("--sketch", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+    parser.add_argument("--fqbn", default=DEFAULT_FQBN)
+    parser.add_argument("--build-path", default="build/attiny85")
+    parser.add_argument("--flash-budget", type=int, default=FLASH_SIZE)
+    parser.add_argument("--ram-budget", type=int, default=RAM_SIZE)
+    parser.add_argument("--stack-reserve", type=int, default=200,
+                        help="RAM kept free for the stack (bytes)")
+    parser.add_argument("--top", type=int, default=30, help="number of symbols to list")
+    args = parser.parse_args()
+
+    elf = args.elf
+    if args.build:
+        elf = build(os.path.normpath(args.sketch), args.fqbn, args.build_path)
+    return report(elf, args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
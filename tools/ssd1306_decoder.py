@@ -0,0 +1,347 @@
+#!/usr/bin/env python3
+#
+# Headless SSD1306 model for regression testing the TinyMinez renderer.
+#
+# The decoder consumes the I2C traffic produced by 'SSD1306Device' (see
+# src/video/ssd1306xled.cpp), feeds it into a model of the controller's
+# GDDRAM and emits one image per displayed frame. Frames can be compared
+# against golden images or against a second capture, which proves that a
+# render optimization (dirty tiles, streaming, page skipping...) produces
+# pixel identical output.
+#
+# Capture format (text, one I2C transaction per line):
+#
+#   3C: 00 B0 00 10     <- optional "<address>:" prefix, then the payload
+#   40 FF 00 81 ...     <- control byte 0x40 = data, 0x00 = command
+#   FRAME               <- a frame is complete (optional, see below)
+#   # comment lines and empty lines are ignored
+#
+# Every line represents START ... STOP. The first payload byte is the
+# SSD1306 control byte: bit 6 (D/C#) selects data or command, bit 7 (Co)
+# means "only one byte follows, then another control byte".
+#
+# If the capture contains FRAME markers (e.g. 'host/simulator --i2c'), a frame
+# is taken at every marker. Otherwise (a logic analyzer capture) a frame ends
+# when page 0 is addressed again after data was written. That guess fails when
+# unchanged pages are skipped (page hashes), use --final in that case.
+#
+# Usage:
+#   ssd1306_decoder.py render capture.txt -o frames/       (frame_0000.png, ...)
+#   ssd1306_decoder.py diff capture.txt --golden golden/   (frame_NNNN.pbm)
+#   ssd1306_decoder.py diff before.txt --against after.txt
+#   ssd1306_decoder.py diff before.txt --against after.txt --final
+#
+# The simulator output can be checked against its own frames:
+#   simulator --script game.txt --frames golden --i2c capture.txt
+#   ssd1306_decoder.py diff capture.txt --golden golden
+#
+
+import argparse
+import glob
+import os
+import re
+import sys
+
+from monoimage import MonoFrame, read_pbm, write_image
+
+WIDTH = 128
+HEIGHT = 64
+PAGES = HEIGHT // 8
+
+# number of argument bytes following a command byte
+COMMAND_ARGUMENTS = {
+    0x20: 1,  # memory addressing mode
+    0x21: 2,  # column address range
+    0x22: 2,  # page address range
+    0x26: 6, 0x27: 6,  # horizontal scroll setup
+    0x29: 5, 0x2A: 5,  # vertical and horizontal scroll setup
+    0x81: 1,  # contrast
+    0x8D: 1,  # charge pump
+    0xA3: 2,  # vertical scroll area
+    0xA8: 1,  # multiplex ratio
+    0xD3: 1,  # display offset
+    0xD5: 1,  # clock divide ratio
+    0xD9: 1,  # pre-charge period
+    0xDA: 1,  # COM pins configuration
+    0xDB: 1,  # Vcomh deselect level
+}
+
+HORIZONTAL, VERTICAL, PAGE = 0, 1, 2
+
+
+class SSD1306:
+    """Models the parts of the SSD1306 that influence the visible image."""
+
+    def __init__(self):
+        self.ram = MonoFrame(WIDTH, HEIGHT)
+        self.addressing = PAGE  # reset value
+        self.column = 0
+        self.page = 0
+        self.column_range = (0, WIDTH - 1)
+        self.page_range = (0, PAGES - 1)
+        self.inverse = False
+        self.display_on = False
+        self.entire_on = False
+        self.segment_remap = False
+        self.com_reversed = False
+        self.start_line = 0
+        # command currently collecting arguments
+        self._command = None
+        self._arguments = []
+        # frame detection (FRAME markers or page 0 after data)
+        self.explicit_frames = False
+        self.data_written = False
+        self.frames = []
+
+    #------------------------------------------------------------
+    def transaction(self, payload):
+        """Processes one I2C transaction (START ... STOP) without the address byte."""
+        n = 0
+        while n < len(payload):
+            control = payload[n]
+            n += 1
+            is_data = bool(control & 0x40)
+            if control & 0x80:
+                # Co = 1 : exactly one byte follows
+                if n < len(payload):
+                    self._byte(payload[n], is_data)
+                    n += 1
+            else:
+                # Co = 0 : the rest of the transaction is a stream
+                for value in payload[n:]:
+                    self._byte(value, is_data)
+                break
+
+    def frame(self):
+        """A FRAME marker: the frame is complete."""
+        self._snapshot()
+
+    def finish(self):
+        """Flushes the last frame at the end of the capture."""
+        if self.data_written and not self.explicit_frames:
+            self._snapshot()
+
+    def visible_frame(self):
+        """Returns the image as the panel shows it."""
+        if self.entire_on:
+            return MonoFrame(WIDTH, HEIGHT, bytes([0xff]) * (WIDTH * PAGES))
+        frame = self.ram
+        if self.start_line:
+            frame = _rotate_lines(frame, self.start_line)
+        # 0xA1/0xC8 (as used by ssd1306_init()) is the upright orientation
+        frame = frame.mirrored(not self.segment_remap, not self.com_reversed)
+        if self.inverse:
+            frame = frame.inverted()
+        if not self.display_on:
+            frame = MonoFrame(WIDTH, HEIGHT)
+        return frame
+
+    #------------------------------------------------------------
+    def _byte(self, value, is_data):
+        if is_data:
+            self._data(value)
+        else:
+            self._command_byte(value)
+
+    def _data(self, value):
+        self.ram.data[self.page * WIDTH + self.column] = value
+        self.data_written = True
+        self._advance()
+
+    def _advance(self):
+        first_column, last_column = self.column_range
+        first_page, last_page = self.page_range
+        if self.addressing == PAGE:
+            # page mode: the column pointer wraps to 0 at the end of the line,
+            # the page doesn't change
+            if self.column < WIDTH - 1:
+                self.column += 1
+            else:
+                self.column = 0
+        elif self.addressing == HORIZONTAL:
+            if self.column < last_column:
+                self.column += 1
+            else:
+                self.column = first_column
+                self.page = first_page if self.page >= last_page else self.page + 1
+        else:
+            if self.page < last_page:
+                self.page += 1
+            else:
+                self.page = first_page
+                self.column = first_column if self.column >= last_column else self.column + 1
+
+    def _command_byte(self, value):
+        if self._command is not None:
+            self._arguments.append(value)
+            if len(self._arguments) == COMMAND_ARGUMENTS[self._command]:
+                command, arguments = self._command, self._arguments
+                self._command, self._arguments = None, []
+                self._execute(command, arguments)
+            return
+        if value in COMMAND_ARGUMENTS:
+            self._command = value
+            self._arguments = []
+            return
+        self._execute(value, [])
+
+    def _execute(self, command, arguments):
+        if command == 0x20:
+            mode = arguments[0] & 0x03
+            if mode != 0x03:
+                self.addressing = mode
+        elif command == 0x21:
+            self.column_range = (arguments[0] & 0x7f, arguments[1] & 0x7f)
+            self.column = self.column_range[0]
+        elif command == 0x22:
+            self.page_range = (arguments[0] & 0x07, arguments[1] & 0x07)
+            self.page = self.page_range[0]
+        elif 0x00 <= command <= 0x0f:
+            # lower column start address (page mode)
+            self.column = (self.column & 0xf0) | command
+        elif 0x10 <= command <= 0x1f:
+            # upper column start address (page mode)
+            self.column = ((command & 0x07) << 4) | (self.column & 0x0f)
+        elif 0xb0 <= command <= 0xb7:
+            # without markers a new frame starts, when page 0 is addressed again after drawing
+            if command == 0xb0 and self.data_written and not self.explicit_frames:
+                self._snapshot()
+            self.page = command & 0x07
+        elif 0x40 <= command <= 0x7f:
+            self.start_line = command & 0x3f
+        elif command in (0xa6, 0xa7):
+            self.inverse = command == 0xa7
+        elif command in (0xa4, 0xa5):
+            self.entire_on = command == 0xa5
+        elif command in (0xae, 0xaf):
+            self.display_on = command == 0xaf
+        elif command in (0xa0, 0xa1):
+            self.segment_remap = command == 0xa1
+        elif command in (0xc0, 0xc8):
+            self.com_reversed = command == 0xc8
+        # everything else (contrast, timing, scrolling...) has no effect on the image
+
+    def _snapshot(self):
+        self.frames.append(self.visible_frame())
+        self.data_written = False
+
+
+def _rotate_lines(frame, start_line):
+    rotated = MonoFrame(frame.width, frame.height)
+    for y in range(frame.height):
+        source = (y + start_line) % frame.height
+        for x in range(frame.width):
+            if frame.pixel(x, source):
+                rotated.data[(y >> 3) * frame.width + x] |= 1 << (y & 0x07)
+    return rotated
+
+
+#--------------------------------------------------------------
+def parse_capture(path):
+    """Yields the payload of every transaction in a capture file, None for a FRAME marker."""
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            if line.upper() == "FRAME":
+                yield None
+                continue
+            # drop the optional address prefix
+            line = re.sub(r"^[0-9A-Fa-f]{1,2}\s*:", "", line)
+            try:
+                yield bytes(int(token, 16) for token in line.replace(",", " ").split())
+            except ValueError:
+                raise SystemExit("%s:%d: invalid hex byte" % (path, number))
+
+
+def decode(path, final=False):
+    """Returns the frames of a capture (only the final image with 'final')."""
+    payloads = list(parse_capture(path))
+    display = SSD1306()
+    display.explicit_frames = None in payloads
+    for payload in payloads:
+        if payload is None:
+            display.frame()
+        else:
+            display.transaction(payload)
+    if final:
+        return [display.visible_frame()]
+    display.finish()
+    return display.frames
+
+
+def report_differences(label, frame, reference):
+    changes = frame.diff(reference)
+    if changes:
+        x0 = min(x for x, _ in changes)
+        y0 = min(y for _, y in changes)
+        x1 = max(x for x, _ in changes)
+        y1 = max(y for _, y in changes)
+        print("%s: %d pixels differ in (%d,%d)-(%d,%d)" % (label, len(changes), x0, y0, x1, y1))
+    return len(changes)
+
+
+#--------------------------------------------------------------
+def command_render(args):
+    frames = decode(args.capture)
+    os.makedirs(args.output, exist_ok=True)
+    for n, frame in enumerate(frames):
+        write_image(os.path.join(args.output, "frame_%04d.%s" % (n, args.format)), frame, args.scale)
+    print("%d frames written to %s" % (len(frames), args.output))
+    return 0
+
+
+def command_diff(args):
+    frames = decode(args.capture, args.final)
+    if args.against:
+        references = decode(args.against, args.final)
+    else:
+        # frame_NNNN.pbm (render) or frame_NNNNNN.pbm (simulator --frames)
+        references = [read_pbm(path) for path in sorted(glob.glob(os.path.join(args.golden, "frame_*.pbm")))]
+        if args.final:
+            references = references[-1:]
+
+    failures = 0
+    if len(frames) != len(references):
+        print("frame count differs: %d vs. %d" % (len(frames), len(references)))
+        failures += 1
+    for n, (frame, reference) in enumerate(zip(frames, references)):
+        if report_differences("frame %d" % n, frame, reference):
+            failures += 1
+            if args.output:
+                os.makedirs(args.output, exist_ok=True)
+                write_image(os.path.join(args.output, "frame_%04d.png" % n), frame, args.scale)
+    if failures == 0:
+        print("%d frames identical" % len(frames))
+    return 1 if failures else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode SSD1306 I2C captures into frames.")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    render = commands.add_parser("render", help="write every frame as an image")
+    render.add_argument("capture")
+    render.add_argument("-o", "--output", default="frames")
+    render.add_argument("-f", "--format", choices=("png", "pbm"), default="png")
+    render.add_argument("-s", "--scale", type=int, default=4, help="PNG zoom factor")
+    render.set_defaults(run=command_render)
+
+    diff = commands.add_parser("diff", help="compare frames against golden images or a second capture")
+    diff.add_argument("capture")
+    reference = diff.add_mutually_exclusive_group(required=True)
+    reference.add_argument("--golden", help="directory with frame_NNNN.pbm files")
+    reference.add_argument("--against", help="second capture file")
+    diff.add_argument("--final", action="store_true",
+                      help="only compare the image at the end of the capture (no frame detection)")
+    diff.add_argument("-o", "--output", help="write mismatching frames here")
+    diff.add_argument("-s", "--scale", type=int, default=4)
+    diff.set_defaults(run=command_diff)
+
+    args = parser.parse_args()
+    return args.run(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())